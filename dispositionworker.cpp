@@ -0,0 +1,178 @@
+#include "dispositionworker.h"
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDate>
+#include <QDateTime>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+DispositionPolicy DispositionPolicy::defaultsFor(const QString &rootPath, Action successAction)
+{
+    QDir root(rootPath);
+    DispositionPolicy policy;
+    policy.successAction = successAction;
+    policy.archiveDir = root.filePath("archive");
+    policy.outboxDir = root.filePath("outbox");
+    policy.quarantineDir = root.filePath("quarantine");
+    return policy;
+}
+
+QString DispositionPolicy::actionName(Action action)
+{
+    switch (action) {
+    case Keep:
+        return "保留";
+    case Archive:
+        return "归档";
+    case HardLink:
+        return "硬链接到发件箱";
+    case Delete:
+        return "删除";
+    }
+    return QString();
+}
+
+DispositionWorker::DispositionWorker(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void DispositionWorker::dispose(const QString &filePath, bool success, const DispositionPolicy &policy)
+{
+    QString action;
+    QString target;
+    QString error;
+    bool ok = true;
+
+    if (!success) {
+        // 失败的文件移入隔离目录
+        if (policy.quarantineDir.isEmpty()) {
+            return;
+        }
+        action = "隔离";
+        ok = moveFile(filePath, policy.quarantineDir, target, error);
+    } else {
+        action = DispositionPolicy::actionName(policy.successAction);
+        switch (policy.successAction) {
+        case DispositionPolicy::Keep:
+            return;
+        case DispositionPolicy::Archive:
+            ok = moveFile(filePath, QDir(policy.archiveDir).filePath(QDate::currentDate().toString("yyyy-MM-dd")), target, error);
+            break;
+        case DispositionPolicy::HardLink:
+            ok = linkFile(filePath, policy.outboxDir, target, error);
+            break;
+        case DispositionPolicy::Delete:
+            ok = deleteFile(filePath, error);
+            break;
+        }
+    }
+
+    record(policy, action, filePath, target, ok, error);
+    emit disposed(filePath, action, target, ok, error);
+}
+
+bool DispositionWorker::moveFile(const QString &source, const QString &targetDir, QString &target, QString &error)
+{
+    if (!QDir().mkpath(targetDir)) {
+        error = QString("无法创建目录 %1").arg(targetDir);
+        return false;
+    }
+
+    target = uniqueTarget(targetDir, QFileInfo(source).fileName());
+    // QFile::rename 在跨卷时会自动退化为复制后删除
+    QFile file(source);
+    if (!file.rename(target)) {
+        error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool DispositionWorker::linkFile(const QString &source, const QString &targetDir, QString &target, QString &error)
+{
+    if (!QDir().mkpath(targetDir)) {
+        error = QString("无法创建目录 %1").arg(targetDir);
+        return false;
+    }
+
+    target = uniqueTarget(targetDir, QFileInfo(source).fileName());
+
+#ifdef Q_OS_WIN
+    bool linked = CreateHardLinkW(reinterpret_cast<const wchar_t *>(QDir::toNativeSeparators(target).utf16()),
+                                  reinterpret_cast<const wchar_t *>(QDir::toNativeSeparators(source).utf16()),
+                                  nullptr);
+#else
+    bool linked = ::link(QFile::encodeName(source).constData(), QFile::encodeName(target).constData()) == 0;
+#endif
+
+    if (!linked) {
+        // 硬链接失败（例如跨卷）时退化为移动
+        qDebug() << "无法创建硬链接，改为移动文件：" << source;
+        return moveFile(source, targetDir, target, error);
+    }
+
+    // 链接成功后从监控目录移除原始路径
+    return deleteFile(source, error);
+}
+
+bool DispositionWorker::deleteFile(const QString &source, QString &error)
+{
+    QFile file(source);
+    if (!file.remove()) {
+        error = file.errorString();
+        return false;
+    }
+    return true;
+}
+
+// 将处理结果追加到归档目录下的 disposition.log
+void DispositionWorker::record(const DispositionPolicy &policy, const QString &action, const QString &source,
+                               const QString &target, bool ok, const QString &error)
+{
+    if (policy.archiveDir.isEmpty() || !QDir().mkpath(policy.archiveDir)) {
+        return;
+    }
+
+    QFile journal(QDir(policy.archiveDir).filePath("disposition.log"));
+    if (!journal.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text)) {
+        qDebug() << "无法写入处理记录：" << journal.errorString();
+        return;
+    }
+
+    QStringList fields;
+    fields << QDateTime::currentDateTime().toString(Qt::ISODate)
+           << action
+           << source
+           << target
+           << (ok ? "OK" : "ERROR")
+           << error;
+    journal.write(fields.join('\t').toUtf8() + '\n');
+}
+
+// 目标文件已存在时追加序号，避免覆盖
+QString DispositionWorker::uniqueTarget(const QString &targetDir, const QString &fileName)
+{
+    QDir dir(targetDir);
+    QString target = dir.filePath(fileName);
+    if (!QFile::exists(target)) {
+        return target;
+    }
+
+    QFileInfo info(fileName);
+    QString suffix = info.completeSuffix().isEmpty() ? QString() : "." + info.completeSuffix();
+    for (int i = 1; ; ++i) {
+        target = dir.filePath(QString("%1_%2%3").arg(info.baseName()).arg(i).arg(suffix));
+        if (!QFile::exists(target)) {
+            return target;
+        }
+    }
+}
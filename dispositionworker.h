@@ -0,0 +1,54 @@
+#ifndef DISPOSITIONWORKER_H
+#define DISPOSITIONWORKER_H
+
+#include <QObject>
+#include <QString>
+#include <QMetaType>
+
+// 每个监控目录的传输后处理策略
+struct DispositionPolicy
+{
+    // 成功发送后的处理方式，顺序与界面下拉框一致
+    enum Action {
+        Keep,      // 保留在原处
+        Archive,   // 移动到按日期划分的归档目录
+        HardLink,  // 硬链接到发件箱后从监控目录移除
+        Delete     // 直接删除
+    };
+
+    Action successAction = Keep;
+    QString archiveDir;     // 归档根目录，其下按 yyyy-MM-dd 建立子目录，同时存放处理记录
+    QString outboxDir;      // 发件箱目录
+    QString quarantineDir;  // 失败文件的隔离目录，为空则失败文件保留在原处
+
+    // 以监控目录下的 archive、outbox、quarantine 子目录作为默认位置
+    static DispositionPolicy defaultsFor(const QString &rootPath, Action successAction);
+    static QString actionName(Action action);
+};
+
+Q_DECLARE_METATYPE(DispositionPolicy)
+
+// 在独立线程中执行文件的归档、链接、删除与隔离，并记录处理结果
+class DispositionWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DispositionWorker(QObject *parent = nullptr);
+
+public slots:
+    void dispose(const QString &filePath, bool success, const DispositionPolicy &policy);
+
+signals:
+    void disposed(const QString &filePath, const QString &action, const QString &target, bool ok, const QString &error);
+
+private:
+    bool moveFile(const QString &source, const QString &targetDir, QString &target, QString &error);
+    bool linkFile(const QString &source, const QString &targetDir, QString &target, QString &error);
+    bool deleteFile(const QString &source, QString &error);
+    void record(const DispositionPolicy &policy, const QString &action, const QString &source,
+                const QString &target, bool ok, const QString &error);
+    static QString uniqueTarget(const QString &targetDir, const QString &fileName);
+};
+
+#endif // DISPOSITIONWORKER_H
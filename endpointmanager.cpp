@@ -0,0 +1,252 @@
+#include "endpointmanager.h"
+#include <QDebug>
+#include <QDateTime>
+#include <QRegularExpression>
+#include "retryscheduler.h"
+
+// 熔断常量：连续失败次数阈值、检查间隔以及熔断时长的指数退避范围
+const int BREAKER_FAILURE_THRESHOLD = 3;
+const int BREAKER_CHECK_INTERVAL_MS = 500;
+const int BREAKER_BASE_COOLDOWN_MS = 2000;
+const int BREAKER_MAX_COOLDOWN_MS = 60000;
+// 吞吐量平滑系数
+const double THROUGHPUT_ALPHA = 0.3;
+
+EndpointManager::EndpointManager(QObject *parent)
+    : QObject(parent)
+    , m_breakerTimer(new QTimer(this))
+{
+    connect(m_breakerTimer, &QTimer::timeout, this, &EndpointManager::checkBreakers);
+    m_breakerTimer->setInterval(BREAKER_CHECK_INTERVAL_MS);
+}
+
+QList<Endpoint> EndpointManager::parseEndpoints(const QString &text, quint16 defaultPort)
+{
+    QList<Endpoint> endpoints;
+    const QStringList items = text.split(QRegularExpression("[,;\\s]+"), Qt::SkipEmptyParts);
+
+    for (const QString &item : items) {
+        Endpoint endpoint;
+        QString address = item;
+
+        // 解析权重，例如 192.168.1.10:65432*2
+        int starIndex = address.indexOf('*');
+        if (starIndex >= 0) {
+            endpoint.weight = qMax(1, address.mid(starIndex + 1).toInt());
+            address = address.left(starIndex);
+        }
+
+        // IPv6 地址带端口时需写成 [fe80::1]:65432，不带方括号且含多个冒号时整体视为主机
+        endpoint.host = address;
+        endpoint.port = defaultPort;
+        if (address.startsWith('[')) {
+            int closeIndex = address.indexOf(']');
+            if (closeIndex < 0) {
+                qDebug() << "忽略无效的接收端地址：" << item;
+                continue;
+            }
+            endpoint.host = address.mid(1, closeIndex - 1);
+            QString rest = address.mid(closeIndex + 1);
+            if (rest.startsWith(':')) {
+                endpoint.port = rest.mid(1).toUShort();
+            } else if (!rest.isEmpty()) {
+                endpoint.port = 0;
+            }
+        } else if (address.count(':') == 1) {
+            int colonIndex = address.indexOf(':');
+            endpoint.host = address.left(colonIndex);
+            endpoint.port = address.mid(colonIndex + 1).toUShort();
+        }
+
+        if (endpoint.host.isEmpty() || endpoint.port == 0) {
+            qDebug() << "忽略无效的接收端地址：" << item;
+            continue;
+        }
+        endpoints.append(endpoint);
+    }
+
+    return endpoints;
+}
+
+void EndpointManager::setEndpoints(const QList<Endpoint> &endpoints)
+{
+    m_endpoints = endpoints;
+
+    for (Endpoint &endpoint : m_endpoints) {
+        endpoint.maxStreams = m_maxStreams;
+        qDebug() << "接收端：" << endpoint.address() << "权重：" << endpoint.weight;
+    }
+
+    if (!m_breakerTimer->isActive()) {
+        m_breakerTimer->start();
+    }
+    emit statisticsChanged();
+}
+
+void EndpointManager::setMaxStreams(int streams)
+{
+    m_maxStreams = qMax(1, streams);
+    for (Endpoint &endpoint : m_endpoints) {
+        endpoint.maxStreams = m_maxStreams;
+    }
+    emit statisticsChanged();
+}
+
+int EndpointManager::acquire()
+{
+    int best = -1;
+    double bestLoad = 0.0;
+
+    for (int i = 0; i < m_endpoints.size(); ++i) {
+        const Endpoint &endpoint = m_endpoints.at(i);
+        if (endpoint.state == Endpoint::Open) {
+            continue;
+        }
+        // 半开状态只允许一个探测传输
+        int streams = endpoint.state == Endpoint::HalfOpen ? 1 : endpoint.maxStreams;
+        if (endpoint.activeTransfers >= streams) {
+            continue;
+        }
+
+        // 按权重归一化的负载，负载相同时优先选择吞吐量更高的接收端
+        double load = double(endpoint.activeTransfers + 1) / endpoint.weight;
+        if (best < 0 || load < bestLoad
+            || (load == bestLoad && endpoint.throughput > m_endpoints.at(best).throughput)) {
+            best = i;
+            bestLoad = load;
+        }
+    }
+
+    if (best >= 0) {
+        m_endpoints[best].activeTransfers++;
+        emit statisticsChanged();
+    }
+    return best;
+}
+
+void EndpointManager::release(int index)
+{
+    if (index < 0 || index >= m_endpoints.size()) {
+        return;
+    }
+    Endpoint &endpoint = m_endpoints[index];
+    endpoint.activeTransfers = qMax(0, endpoint.activeTransfers - 1);
+    emit statisticsChanged();
+}
+
+// 半开状态下探测传输连接成功，接收端恢复
+void EndpointManager::reportConnected(int index)
+{
+    if (index < 0 || index >= m_endpoints.size()) {
+        return;
+    }
+    Endpoint &endpoint = m_endpoints[index];
+    if (endpoint.state != Endpoint::HalfOpen) {
+        return;
+    }
+
+    endpoint.state = Endpoint::Closed;
+    qDebug() << "\033[32m接收端" << endpoint.address() << "探测成功，已恢复在线。\033[0m";
+    emit endpointAvailable(index);
+    emit statisticsChanged();
+}
+
+void EndpointManager::reportSuccess(int index, qint64 bytes, qint64 elapsedMs)
+{
+    if (index < 0 || index >= m_endpoints.size()) {
+        return;
+    }
+    Endpoint &endpoint = m_endpoints[index];
+    endpoint.bytesSent += bytes;
+    endpoint.filesSent++;
+    endpoint.consecutiveFailures = 0;
+    endpoint.tripCount = 0;
+
+    if (elapsedMs > 0) {
+        double speed = bytes / (1024.0 * 1024.0) / (elapsedMs / 1000.0);
+        endpoint.throughput = endpoint.filesSent == 1
+            ? speed
+            : THROUGHPUT_ALPHA * speed + (1.0 - THROUGHPUT_ALPHA) * endpoint.throughput;
+    }
+    emit statisticsChanged();
+}
+
+void EndpointManager::reportError(int index, bool countsTowardBreaker)
+{
+    if (index < 0 || index >= m_endpoints.size()) {
+        return;
+    }
+    Endpoint &endpoint = m_endpoints[index];
+    endpoint.errors++;
+
+    if (countsTowardBreaker) {
+        endpoint.consecutiveFailures++;
+        // 半开探测失败或连续失败达到阈值时熔断
+        if (endpoint.state == Endpoint::HalfOpen || endpoint.consecutiveFailures >= BREAKER_FAILURE_THRESHOLD) {
+            trip(index);
+            return;
+        }
+    }
+    emit statisticsChanged();
+}
+
+void EndpointManager::reportConnectFailure(int index, const QString &reason)
+{
+    if (index < 0 || index >= m_endpoints.size()) {
+        return;
+    }
+    qDebug() << "\033[31m接收端" << m_endpoints.at(index).address() << "连接失败：" << reason << "\033[0m";
+    m_endpoints[index].errors++;
+    trip(index);
+}
+
+QString EndpointManager::statisticsText() const
+{
+    QStringList lines;
+    for (const Endpoint &endpoint : m_endpoints) {
+        lines << QString("%1 [%2] 活动：%3 成功：%4 错误：%5 已发送：%6 MB 速度：%7 MB/s")
+                     .arg(endpoint.address())
+                     .arg(endpoint.state == Endpoint::Closed ? "在线"
+                          : endpoint.state == Endpoint::HalfOpen ? "探测中" : "熔断")
+                     .arg(endpoint.activeTransfers)
+                     .arg(endpoint.filesSent)
+                     .arg(endpoint.errors)
+                     .arg(endpoint.bytesSent / (1024.0 * 1024.0), 0, 'f', 2)
+                     .arg(endpoint.throughput, 0, 'f', 2);
+    }
+    return lines.join('\n');
+}
+
+// 熔断时长结束后转为半开状态，放行一个传输作为探测
+void EndpointManager::checkBreakers()
+{
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (int i = 0; i < m_endpoints.size(); ++i) {
+        Endpoint &endpoint = m_endpoints[i];
+        if (endpoint.state == Endpoint::Open && endpoint.retryAt <= now) {
+            endpoint.state = Endpoint::HalfOpen;
+            qDebug() << "接收端" << endpoint.address() << "熔断结束，发送一个探测传输。";
+            emit endpointAvailable(i);
+            emit statisticsChanged();
+        }
+    }
+}
+
+// 熔断接收端：暂停向其分派文件，熔断时长随连续熔断次数指数增长
+void EndpointManager::trip(int index)
+{
+    Endpoint &endpoint = m_endpoints[index];
+    // 并发传输先后失败时只熔断一次
+    if (endpoint.state == Endpoint::Open) {
+        emit statisticsChanged();
+        return;
+    }
+    endpoint.state = Endpoint::Open;
+    endpoint.consecutiveFailures = 0;
+    endpoint.tripCount++;
+
+    int cooldown = RetryScheduler::backoffDelay(endpoint.tripCount, BREAKER_BASE_COOLDOWN_MS, BREAKER_MAX_COOLDOWN_MS);
+    endpoint.retryAt = QDateTime::currentMSecsSinceEpoch() + cooldown;
+    qDebug() << "\033[31m接收端" << endpoint.address() << "已熔断，" << cooldown << "毫秒后重新探测。\033[0m";
+    emit statisticsChanged();
+}
@@ -0,0 +1,87 @@
+#ifndef ENDPOINTMANAGER_H
+#define ENDPOINTMANAGER_H
+
+#include <QObject>
+#include <QList>
+#include <QString>
+#include <QTimer>
+
+// 单个接收端的配置、熔断状态与统计数据
+struct Endpoint
+{
+    // 熔断器状态：正常、熔断（暂停分派）、半开（放行一次探测传输）
+    enum BreakerState {
+        Closed,
+        Open,
+        HalfOpen
+    };
+
+    QString host;
+    quint16 port = 0;
+    int weight = 1;         // 权重，越大分到的文件越多
+    int maxStreams = 1;     // 该接收端允许的并发传输数
+
+    BreakerState state = Closed;
+    int tripCount = 0;       // 连续熔断次数，用于计算退避时长
+    qint64 retryAt = 0;      // 熔断结束时间（毫秒时间戳）
+    int activeTransfers = 0;
+    int consecutiveFailures = 0;
+
+    qint64 bytesSent = 0;
+    int filesSent = 0;
+    int errors = 0;
+    double throughput = 0.0; // 平滑后的吞吐量 (MB/s)
+
+    QString address() const
+    {
+        return host.contains(':') ? QString("[%1]:%2").arg(host).arg(port) : QString("%1:%2").arg(host).arg(port);
+    }
+};
+
+// 管理多个接收端：负载均衡选择、故障转移和熔断
+class EndpointManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit EndpointManager(QObject *parent = nullptr);
+
+    // 解析形如 "host[:port][*weight]" 的列表，以逗号、分号或空白分隔
+    static QList<Endpoint> parseEndpoints(const QString &text, quint16 defaultPort);
+
+    void setEndpoints(const QList<Endpoint> &endpoints);
+    int count() const { return m_endpoints.size(); }
+    const Endpoint &endpoint(int index) const { return m_endpoints.at(index); }
+    // 设置每个接收端的并发传输数，对之后设置的接收端列表同样生效
+    void setMaxStreams(int streams);
+
+    // 选择负载最低（按权重归一化）的可用接收端并占用一个并发槽位，无可用时返回 -1
+    // 半开状态的接收端只放行一个传输作为探测
+    int acquire();
+    void release(int index);
+
+    void reportConnected(int index);
+    void reportSuccess(int index, qint64 bytes, qint64 elapsedMs);
+    // 记录错误；countsTowardBreaker 为 false 时（如服务器明确返回 FAILURE）不计入熔断
+    void reportError(int index, bool countsTowardBreaker = true);
+    // 连接阶段失败：立即熔断该接收端，文件交由其他接收端处理
+    void reportConnectFailure(int index, const QString &reason);
+
+    QString statisticsText() const;
+
+signals:
+    void endpointAvailable(int index);
+    void statisticsChanged();
+
+private slots:
+    void checkBreakers();
+
+private:
+    void trip(int index);
+
+    QList<Endpoint> m_endpoints;
+    QTimer *m_breakerTimer;
+    int m_maxStreams = 1;
+};
+
+#endif // ENDPOINTMANAGER_H
@@ -61,6 +61,9 @@ void FileSenderWorker::process(const QString& filePath)
 void FileSenderWorker::onConnected()
 {
     qDebug() << "Successfully connected to server.";
+    if (m_tuning.sendBufferSize > 0) {
+        myTcpSocket->setSocketOption(QAbstractSocket::SendBufferSizeSocketOption, m_tuning.sendBufferSize);
+    }
     sendFileMetadata();
     m_speedTimer.start();
     // Connect bytesWritten signal only after connection is established
@@ -69,8 +72,13 @@ void FileSenderWorker::onConnected()
 
 void FileSenderWorker::onBytesWritten(qint64 bytes)
 {
-    m_totalSent += bytes;
+    if (!myFile || !myFile->isOpen()) {
+        return;
+    }
+
     m_totalBytesSentInPeriod += bytes;
+    // Progress counts file data already handed to the kernel; the header is flushed first, so it never shows up here
+    m_totalSent = qBound<qint64>(0, myFile->pos() - myTcpSocket->bytesToWrite(), m_fileSize);
 
     if (m_fileSize > 0) {
         int percentage = (m_totalSent * 100) / m_fileSize;
@@ -83,7 +91,10 @@ void FileSenderWorker::onBytesWritten(qint64 bytes)
         m_totalBytesSentInPeriod = 0;
     }
 
-    sendNextChunk();
+    // Refill only once the socket buffer has drained below the low-water mark
+    if (myTcpSocket->bytesToWrite() < m_tuning.lowWaterMark) {
+        sendNextChunk();
+    }
 }
 
 void FileSenderWorker::onReadyRead()
@@ -147,10 +158,28 @@ void FileSenderWorker::sendNextChunk()
         return;
     }
 
-    if (m_totalSent < m_fileSize) {
-        QByteArray buffer = myFile->read(16 * 1024);
-        myTcpSocket->write(buffer);
-    } else {
+    // Keep the socket buffer filled up to the high-water mark
+    while (myFile->pos() < m_fileSize && myTcpSocket->bytesToWrite() < m_tuning.highWaterMark) {
+        QByteArray buffer = myFile->read(qMin(m_fileSize - myFile->pos(), (qint64)m_tuning.chunkSize));
+        if (buffer.isEmpty()) {
+            closeConnectionAndFinish("Failed to read file.");
+            return;
+        }
+
+        qint64 written = myTcpSocket->write(buffer);
+        if (written < 0) {
+            return; // onSocketError handles the failure
+        }
+        if (written < buffer.size()) {
+            // Partial write: rewind so the unwritten tail is read again on the next refill
+            myFile->seek(myFile->pos() - (buffer.size() - written));
+            break;
+        }
+    }
+
+    // Everything has been handed to the kernel, wait for the server's answer
+    if (myFile->pos() >= m_fileSize && myTcpSocket->bytesToWrite() == 0) {
+        m_totalSent = m_fileSize;
         myFile->close();
 
         disconnect(myTcpSocket, &QTcpSocket::bytesWritten, this, &FileSenderWorker::onBytesWritten);
@@ -181,6 +210,8 @@ void FileSenderWorker::closeConnectionAndFinish(const QString& errorMessage)
         responseTimer->stop();
     }
 
+    // Drop the per-transfer connection so the next file does not receive it twice
+    disconnect(myTcpSocket, &QTcpSocket::bytesWritten, this, &FileSenderWorker::onBytesWritten);
     myTcpSocket->disconnectFromHost();
     m_isSending = false;
     emit finished();
@@ -6,6 +6,7 @@
 #include <QFile>
 #include <QElapsedTimer>
 #include <QTimer>
+#include "transfertuner.h"
 
 class FileSenderWorker : public QObject
 {
@@ -21,6 +22,9 @@ public:
 public slots:
     void process(const QString& filePath);
     void setSendingStatus(bool isSending) { m_isSending = isSending; }
+    // Chunk size, socket buffer and water marks; the owner should pass TransferTuner::tuning()
+    // and forward TransferTuner::tuningChanged. Until then the TransferTuning defaults are used.
+    void setTuning(const TransferTuning &tuning) { m_tuning = tuning; }
 
 signals:
     void progress(int value);
@@ -54,6 +58,7 @@ private:
     qint64 m_totalBytesSentInPeriod;
 
     QTimer *responseTimer;
+    TransferTuning m_tuning;
 };
 
 #endif // FILESENDERWORKER_H
@@ -0,0 +1,728 @@
+#include "iouringengine.h"
+
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+// 每个完成事件的 user_data 由槽位序号和操作标记组成
+enum Tag : unsigned {
+    TagOpen,
+    TagStatx,
+    TagSocket,
+    TagConnect,
+    TagConnectTimeout,
+    TagRead,
+    TagSend,
+    TagRecv,
+    TagRecvTimeout,
+    TagCloseFile,
+    TagCloseSocket,
+    TagWakeup
+};
+
+// 每个槽位同时在途的 SQE 不超过 3 个（连接阶段），另有一个唤醒读操作
+const unsigned SQES_PER_SLOT = 8;
+const unsigned RESPONSE_BUFFER_SIZE = 64;
+// 唤醒读操作使用的槽位序号，不对应任何槽位
+const unsigned WAKEUP_INDEX = 0xffffff;
+// io_uring_enter 返回 EAGAIN/EBUSY 且没有完成事件可处理时，最多重试的次数（每次间隔 1 毫秒）
+const int MAX_ENTER_STALLS = 1000;
+
+uint64_t makeUserData(unsigned index, unsigned tag)
+{
+    return (static_cast<uint64_t>(index) << 8) | tag;
+}
+
+int64_t millisecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+__kernel_timespec toTimespec(int milliseconds)
+{
+    __kernel_timespec ts;
+    ts.tv_sec = milliseconds / 1000;
+    ts.tv_nsec = static_cast<long long>(milliseconds % 1000) * 1000000;
+    return ts;
+}
+
+} // namespace
+
+struct IoUringEngine::Slot
+{
+    enum State {
+        Idle,
+        Opening,
+        Connecting,
+        Reading,
+        Sending,
+        Receiving,
+        Closing
+    };
+
+    State state = Idle;
+    Job job;
+    Result result;
+    int pending = 0;            // 尚未收到的完成事件数
+
+    int openRes = 0;
+    int statxRes = 0;
+    int socketRes = 0;
+    int connectRes = 0;
+    bool fileOpen = false;
+    bool socketOpen = false;
+
+    struct statx stx;
+    sockaddr_storage address;
+    socklen_t addressLength = 0;
+    __kernel_timespec connectTimeout;
+    __kernel_timespec responseTimeout;
+
+    char *buffer = nullptr;     // 该槽位注册的缓冲区
+    int64_t fileSize = 0;
+    int64_t offset = 0;
+    unsigned headerLength = 0;  // 下一次发送时位于缓冲区开头的文件头长度
+    unsigned sendLength = 0;
+
+    std::chrono::steady_clock::time_point startedAt;
+    std::chrono::steady_clock::time_point connectStartedAt;
+};
+
+IoUringEngine::IoUringEngine(unsigned slots, unsigned bufferSize, int connectTimeoutMs, int responseTimeoutMs)
+    : m_slotCount(slots)
+    , m_bufferSize(bufferSize)
+    , m_connectTimeoutMs(connectTimeoutMs)
+    , m_responseTimeoutMs(responseTimeoutMs)
+    , m_slots(slots)
+{
+}
+
+IoUringEngine::~IoUringEngine()
+{
+    if (m_ringFd >= 0) {
+        close(m_ringFd);
+    }
+    if (m_wakeupFd >= 0) {
+        close(m_wakeupFd);
+    }
+    if (m_sqes) {
+        munmap(m_sqes, m_sqesSize);
+    }
+    if (m_cqRing && m_cqRing != m_sqRing) {
+        munmap(m_cqRing, m_cqRingSize);
+    }
+    if (m_sqRing) {
+        munmap(m_sqRing, m_sqRingSize);
+    }
+    free(m_buffers);
+    free(m_scratchSqe);
+}
+
+bool IoUringEngine::init(std::string &error)
+{
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    // 某个 SQE 准备失败时继续提交后面的 SQE，失败的操作以完成事件的形式返回
+    params.flags = IORING_SETUP_SUBMIT_ALL;
+
+    m_ringFd = static_cast<int>(syscall(__NR_io_uring_setup, m_slotCount * SQES_PER_SLOT, &params));
+    m_syscalls++;
+    if (m_ringFd < 0) {
+        error = std::string("io_uring_setup: ") + strerror(errno);
+        return false;
+    }
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP)) {
+        error = "kernel lacks IORING_FEAT_SINGLE_MMAP";
+        return false;
+    }
+
+    // 映射提交队列、完成队列和 SQE 数组
+    m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+    m_sqRing = mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_SQ_RING);
+    if (m_sqRing == MAP_FAILED) {
+        m_sqRing = nullptr;
+        error = std::string("mmap sq ring: ") + strerror(errno);
+        return false;
+    }
+    m_cqRing = m_sqRing;
+
+    m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    m_sqes = static_cast<io_uring_sqe *>(mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_ringFd, IORING_OFF_SQES));
+    if (m_sqes == MAP_FAILED) {
+        m_sqes = nullptr;
+        error = std::string("mmap sqes: ") + strerror(errno);
+        return false;
+    }
+
+    char *sq = static_cast<char *>(m_sqRing);
+    m_sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    m_sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    m_sqMask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    m_sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    m_sqEntries = params.sq_entries;
+    m_sqLocalTail = *m_sqTail;
+
+    char *cq = static_cast<char *>(m_cqRing);
+    m_cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    m_cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    m_cqMask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    m_cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+    // 确认内核支持用到的全部操作
+    const size_t probeSize = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+    std::vector<char> probeBuffer(probeSize, 0);
+    io_uring_probe *probe = reinterpret_cast<io_uring_probe *>(probeBuffer.data());
+    m_syscalls++;
+    if (syscall(__NR_io_uring_register, m_ringFd, IORING_REGISTER_PROBE, probe, 256) < 0) {
+        error = std::string("io_uring probe: ") + strerror(errno);
+        return false;
+    }
+    const unsigned requiredOps[] = {
+        IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_SOCKET, IORING_OP_CONNECT, IORING_OP_READ_FIXED,
+        IORING_OP_SEND, IORING_OP_RECV, IORING_OP_LINK_TIMEOUT, IORING_OP_CLOSE, IORING_OP_READ
+    };
+    for (unsigned op : requiredOps) {
+        if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+            error = "kernel does not support io_uring opcode " + std::to_string(op);
+            return false;
+        }
+    }
+
+    // 注册直接描述符表：每个槽位一个文件、一个 socket，初始为空
+    std::vector<int> files(m_slotCount * 2, -1);
+    m_syscalls++;
+    if (syscall(__NR_io_uring_register, m_ringFd, IORING_REGISTER_FILES, files.data(), files.size()) < 0) {
+        error = std::string("io_uring register files: ") + strerror(errno);
+        return false;
+    }
+
+    // 注册每个槽位的读写缓冲区
+    if (posix_memalign(reinterpret_cast<void **>(&m_buffers), 4096, static_cast<size_t>(m_bufferSize) * m_slotCount) != 0) {
+        m_buffers = nullptr;
+        error = "failed to allocate io_uring buffers";
+        return false;
+    }
+    std::vector<iovec> iovecs(m_slotCount);
+    for (unsigned i = 0; i < m_slotCount; ++i) {
+        m_slots[i].buffer = m_buffers + static_cast<size_t>(i) * m_bufferSize;
+        iovecs[i].iov_base = m_slots[i].buffer;
+        iovecs[i].iov_len = m_bufferSize;
+    }
+    m_syscalls++;
+    if (syscall(__NR_io_uring_register, m_ringFd, IORING_REGISTER_BUFFERS, iovecs.data(), iovecs.size()) < 0) {
+        error = std::string("io_uring register buffers: ") + strerror(errno);
+        return false;
+    }
+
+    m_syscalls++;
+    m_wakeupFd = eventfd(0, EFD_CLOEXEC);
+    if (m_wakeupFd < 0) {
+        error = std::string("eventfd: ") + strerror(errno);
+        return false;
+    }
+    m_scratchSqe = static_cast<io_uring_sqe *>(calloc(1, sizeof(io_uring_sqe)));
+
+    return true;
+}
+
+void IoUringEngine::run(const std::function<bool(Job &)> &nextJob, const std::function<void(const Result &)> &onResult)
+{
+    if (m_failed) {
+        return;
+    }
+    m_onResult = onResult;
+    bool jobsAvailable = true;
+    int stalls = 0;
+
+    while (!m_failed) {
+        // 用新文件填满所有空闲槽位
+        for (unsigned i = 0; i < m_slotCount && jobsAvailable && !m_failed; ++i) {
+            while (m_slots[i].state == Slot::Idle) {
+                Job job;
+                if (!nextJob(job)) {
+                    jobsAvailable = false;
+                    break;
+                }
+                startSlot(i, job);
+            }
+        }
+
+        bool busy = false;
+        for (const Slot &slot : m_slots) {
+            busy = busy || slot.state != Slot::Idle;
+        }
+        if (!busy) {
+            break;
+        }
+
+        // 一次系统调用提交本轮所有 SQE 并等待至少一个完成事件；新文件入队时由唤醒读操作结束等待
+        armWakeup();
+        int ret = submitAndWait(1);
+        if (ret < 0 && ret != -EAGAIN && ret != -EBUSY) {
+            fail(-ret);
+            break;
+        }
+
+        unsigned reaped = reapCompletions();
+        if (ret < 0 && reaped == 0) {
+            // 内核暂时无法接受提交且没有完成事件可处理：短暂等待后重试，持续失败则放弃，避免空转
+            if (++stalls > MAX_ENTER_STALLS) {
+                fail(-ret);
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        } else {
+            stalls = 0;
+        }
+
+        // 槽位释放或被唤醒后再尝试获取新文件
+        jobsAvailable = true;
+    }
+
+    m_onResult = nullptr;
+}
+
+void IoUringEngine::wakeup()
+{
+    uint64_t one = 1;
+    ssize_t written = write(m_wakeupFd, &one, sizeof(one));
+    (void)written; // 计数器溢出前 eventfd 写入不会失败，且已有未读的唤醒时无需再次唤醒
+}
+
+// 在 eventfd 上挂一个读操作，wakeup() 写入后该操作完成，使等待中的 io_uring_enter 返回
+void IoUringEngine::armWakeup()
+{
+    if (m_wakeupArmed) {
+        return;
+    }
+    io_uring_sqe *sqe = nextSqe();
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = m_wakeupFd;
+    sqe->addr = reinterpret_cast<uint64_t>(&m_wakeupValue);
+    sqe->len = sizeof(m_wakeupValue);
+    sqe->user_data = makeUserData(WAKEUP_INDEX, TagWakeup);
+    m_wakeupArmed = true;
+}
+
+unsigned IoUringEngine::reapCompletions()
+{
+    unsigned head = *m_cqHead;
+    unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+    unsigned reaped = 0;
+    while (head != tail) {
+        const io_uring_cqe &cqe = m_cqes[head & *m_cqMask];
+        handleCompletion(static_cast<unsigned>(cqe.user_data >> 8), static_cast<unsigned>(cqe.user_data & 0xff), cqe.res);
+        ++head;
+        ++reaped;
+    }
+    __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+    return reaped;
+}
+
+// 无法恢复的错误：停止引擎，在途文件由调用方改用其他发送路径重新发送
+void IoUringEngine::fail(int error)
+{
+    if (m_failed) {
+        return;
+    }
+    m_failed = true;
+    m_errorString = std::string("io_uring_enter: ") + strerror(error);
+}
+
+void IoUringEngine::startSlot(unsigned index, const Job &job)
+{
+    Slot &slot = m_slots[index];
+    char *buffer = slot.buffer;
+    slot = Slot();
+    slot.buffer = buffer;
+    slot.job = job;
+    slot.result.id = job.id;
+    slot.startedAt = std::chrono::steady_clock::now();
+
+    if (!parseAddress(index)) {
+        slot.result.connectFailed = true;
+        slot.result.error = EINVAL;
+        finishSlot(index);
+        return;
+    }
+    slot.connectTimeout = toTimespec(m_connectTimeoutMs);
+    slot.responseTimeout = toTimespec(m_responseTimeoutMs);
+
+    // 打开文件（直接描述符 2*index）
+    io_uring_sqe *sqe = nextSqe();
+    sqe->opcode = IORING_OP_OPENAT;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = reinterpret_cast<uint64_t>(slot.job.path.c_str());
+    sqe->open_flags = O_RDONLY; // 直接描述符不允许 O_CLOEXEC
+    sqe->file_index = index * 2 + 1;
+    sqe->user_data = makeUserData(index, TagOpen);
+
+    // 获取文件大小
+    sqe = nextSqe();
+    sqe->opcode = IORING_OP_STATX;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = reinterpret_cast<uint64_t>(slot.job.path.c_str());
+    sqe->len = STATX_SIZE;
+    sqe->off = reinterpret_cast<uint64_t>(&slot.stx);
+    sqe->user_data = makeUserData(index, TagStatx);
+
+    slot.state = Slot::Opening;
+    slot.pending = 2;
+}
+
+// 创建 socket（直接描述符 2*index+1），链接连接操作和连接超时
+void IoUringEngine::submitConnect(unsigned index)
+{
+    Slot &slot = m_slots[index];
+    slot.connectStartedAt = std::chrono::steady_clock::now();
+
+    io_uring_sqe *sqe = nextSqe();
+    sqe->opcode = IORING_OP_SOCKET;
+    sqe->fd = slot.address.ss_family;
+    sqe->off = SOCK_STREAM;
+    sqe->file_index = index * 2 + 2;
+    sqe->flags = IOSQE_IO_LINK;
+    sqe->user_data = makeUserData(index, TagSocket);
+
+    sqe = nextSqe();
+    sqe->opcode = IORING_OP_CONNECT;
+    sqe->fd = static_cast<int>(index * 2 + 1);
+    sqe->flags = IOSQE_FIXED_FILE | IOSQE_IO_LINK;
+    sqe->addr = reinterpret_cast<uint64_t>(&slot.address);
+    sqe->off = slot.addressLength;
+    sqe->user_data = makeUserData(index, TagConnect);
+
+    sqe = nextSqe();
+    sqe->opcode = IORING_OP_LINK_TIMEOUT;
+    sqe->fd = -1;
+    sqe->addr = reinterpret_cast<uint64_t>(&slot.connectTimeout);
+    sqe->len = 1;
+    sqe->user_data = makeUserData(index, TagConnectTimeout);
+
+    slot.state = Slot::Connecting;
+    slot.pending = 3;
+}
+
+void IoUringEngine::handleCompletion(unsigned index, unsigned tag, int res)
+{
+    if (tag == TagWakeup) {
+        m_wakeupArmed = false;
+        return;
+    }
+    if (index >= m_slotCount) {
+        return;
+    }
+    Slot &slot = m_slots[index];
+    slot.pending--;
+
+    switch (tag) {
+    case TagOpen:
+        slot.openRes = res;
+        slot.fileOpen = res >= 0;
+        break;
+    case TagStatx:
+        slot.statxRes = res;
+        break;
+    case TagSocket:
+        slot.socketRes = res;
+        slot.socketOpen = res >= 0;
+        break;
+    case TagConnect:
+        slot.connectRes = res;
+        slot.result.connectMs = millisecondsSince(slot.connectStartedAt);
+        break;
+    case TagRead:
+        if (res <= 0) {
+            slot.result.fileFailed = true;
+            slot.result.error = res < 0 ? -res : EIO; // 文件在发送过程中被截断
+        } else {
+            slot.offset += res;
+            slot.sendLength = slot.headerLength + static_cast<unsigned>(res);
+            slot.headerLength = 0;
+        }
+        break;
+    case TagSend:
+        if (res < 0) {
+            slot.result.error = -res;
+        } else if (static_cast<unsigned>(res) < slot.sendLength) {
+            slot.result.error = ECONNRESET;
+        } else {
+            slot.result.bytes = slot.offset;
+        }
+        break;
+    case TagRecv:
+        if (res > 0) {
+            slot.result.response.assign(slot.buffer, static_cast<size_t>(res));
+        } else {
+            // 超时会取消接收操作，连接关闭则返回 0
+            slot.result.error = res == -ECANCELED ? ETIME : (res == 0 ? ECONNRESET : -res);
+        }
+        break;
+    default:
+        break;
+    }
+
+    if (slot.pending > 0) {
+        return;
+    }
+
+    switch (slot.state) {
+    case Slot::Opening:
+        if (!slot.fileOpen || slot.statxRes < 0) {
+            slot.result.fileFailed = true;
+            slot.result.error = -(slot.fileOpen ? slot.statxRes : slot.openRes);
+            submitClose(index);
+        } else {
+            // 文件头：4 字节文件名长度 + 文件名 + 16 字节右对齐的文件大小，与 Qt 路径一致
+            slot.fileSize = static_cast<int64_t>(slot.stx.stx_size);
+            int32_t nameLength = static_cast<int32_t>(slot.job.fileName.size());
+            char sizeField[17];
+            snprintf(sizeField, sizeof(sizeField), "%16lld", static_cast<long long>(slot.fileSize));
+            unsigned headerLength = sizeof(nameLength) + slot.job.fileName.size() + 16;
+            if (headerLength > m_bufferSize / 2) {
+                slot.result.fileFailed = true;
+                slot.result.error = ENAMETOOLONG;
+                submitClose(index);
+                break;
+            }
+            memcpy(slot.buffer, &nameLength, sizeof(nameLength));
+            memcpy(slot.buffer + sizeof(nameLength), slot.job.fileName.data(), slot.job.fileName.size());
+            memcpy(slot.buffer + sizeof(nameLength) + slot.job.fileName.size(), sizeField, 16);
+            slot.headerLength = headerLength;
+            submitConnect(index);
+        }
+        break;
+    case Slot::Connecting:
+        if (!slot.socketOpen || slot.connectRes != 0) {
+            slot.result.connectFailed = true;
+            int res = !slot.socketOpen ? slot.socketRes : slot.connectRes;
+            slot.result.error = res == -ECANCELED ? ETIMEDOUT : -res;
+            submitClose(index);
+        } else {
+            submitReadOrSend(index);
+        }
+        break;
+    case Slot::Reading:
+        if (slot.result.fileFailed) {
+            submitClose(index);
+            break;
+        }
+        {
+            io_uring_sqe *sqe = nextSqe();
+            sqe->opcode = IORING_OP_SEND;
+            sqe->fd = static_cast<int>(index * 2 + 1);
+            sqe->flags = IOSQE_FIXED_FILE;
+            sqe->addr = reinterpret_cast<uint64_t>(slot.buffer);
+            sqe->len = slot.sendLength;
+            sqe->msg_flags = MSG_WAITALL | MSG_NOSIGNAL;
+            sqe->user_data = makeUserData(index, TagSend);
+            slot.state = Slot::Sending;
+            slot.pending = 1;
+        }
+        break;
+    case Slot::Sending:
+        if (slot.result.error != 0) {
+            submitClose(index);
+        } else {
+            submitReadOrSend(index);
+        }
+        break;
+    case Slot::Receiving:
+        slot.result.success = slot.result.response == "SUCCESS";
+        submitClose(index);
+        break;
+    case Slot::Closing:
+        finishSlot(index);
+        break;
+    case Slot::Idle:
+        break;
+    }
+}
+
+// 还有数据时读取下一块；全部发送后等待服务器响应
+void IoUringEngine::submitReadOrSend(unsigned index)
+{
+    Slot &slot = m_slots[index];
+    io_uring_sqe *sqe = nextSqe();
+
+    if (slot.offset < slot.fileSize) {
+        // 读入注册缓冲区中文件头之后的位置，使小文件的文件头和数据只需一次发送
+        int64_t remaining = slot.fileSize - slot.offset;
+        unsigned length = static_cast<unsigned>(std::min<int64_t>(remaining, m_bufferSize - slot.headerLength));
+        sqe->opcode = IORING_OP_READ_FIXED;
+        sqe->fd = static_cast<int>(index * 2);
+        sqe->flags = IOSQE_FIXED_FILE;
+        sqe->addr = reinterpret_cast<uint64_t>(slot.buffer + slot.headerLength);
+        sqe->len = length;
+        sqe->off = static_cast<uint64_t>(slot.offset);
+        sqe->buf_index = static_cast<uint16_t>(index);
+        sqe->user_data = makeUserData(index, TagRead);
+        slot.state = Slot::Reading;
+        slot.pending = 1;
+    } else if (slot.headerLength > 0) {
+        // 空文件：只发送文件头
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = static_cast<int>(index * 2 + 1);
+        sqe->flags = IOSQE_FIXED_FILE;
+        sqe->addr = reinterpret_cast<uint64_t>(slot.buffer);
+        sqe->len = slot.headerLength;
+        sqe->msg_flags = MSG_WAITALL | MSG_NOSIGNAL;
+        sqe->user_data = makeUserData(index, TagSend);
+        slot.sendLength = slot.headerLength;
+        slot.headerLength = 0;
+        slot.state = Slot::Sending;
+        slot.pending = 1;
+    } else {
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = static_cast<int>(index * 2 + 1);
+        sqe->flags = IOSQE_FIXED_FILE | IOSQE_IO_LINK;
+        sqe->addr = reinterpret_cast<uint64_t>(slot.buffer);
+        sqe->len = RESPONSE_BUFFER_SIZE;
+        sqe->user_data = makeUserData(index, TagRecv);
+
+        sqe = nextSqe();
+        sqe->opcode = IORING_OP_LINK_TIMEOUT;
+        sqe->fd = -1;
+        sqe->addr = reinterpret_cast<uint64_t>(&slot.responseTimeout);
+        sqe->len = 1;
+        sqe->user_data = makeUserData(index, TagRecvTimeout);
+        slot.state = Slot::Receiving;
+        slot.pending = 2;
+    }
+}
+
+// 关闭该槽位打开的直接描述符
+void IoUringEngine::submitClose(unsigned index)
+{
+    Slot &slot = m_slots[index];
+    slot.state = Slot::Closing;
+    slot.pending = 0;
+
+    if (slot.fileOpen) {
+        io_uring_sqe *sqe = nextSqe();
+        sqe->opcode = IORING_OP_CLOSE;
+        sqe->file_index = index * 2 + 1;
+        sqe->user_data = makeUserData(index, TagCloseFile);
+        slot.pending++;
+    }
+    if (slot.socketOpen) {
+        io_uring_sqe *sqe = nextSqe();
+        sqe->opcode = IORING_OP_CLOSE;
+        sqe->file_index = index * 2 + 2;
+        sqe->user_data = makeUserData(index, TagCloseSocket);
+        slot.pending++;
+    }
+
+    if (slot.pending == 0) {
+        finishSlot(index);
+    }
+}
+
+void IoUringEngine::finishSlot(unsigned index)
+{
+    Slot &slot = m_slots[index];
+    slot.result.elapsedMs = millisecondsSince(slot.startedAt);
+    slot.state = Slot::Idle;
+    m_filesCompleted++;
+    if (m_onResult) {
+        m_onResult(slot.result);
+    }
+}
+
+// 只接受数字地址：AI_NUMERICHOST 不会发起 DNS 查询，也能解析带 scope id 的 IPv6 地址
+bool IoUringEngine::parseAddress(unsigned index)
+{
+    Slot &slot = m_slots[index];
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_NUMERICHOST | AI_NUMERICSERV;
+
+    std::string port = std::to_string(slot.job.port);
+    addrinfo *info = nullptr;
+    if (getaddrinfo(slot.job.host.c_str(), port.c_str(), &hints, &info) != 0 || !info) {
+        return false;
+    }
+    memcpy(&slot.address, info->ai_addr, info->ai_addrlen);
+    slot.addressLength = info->ai_addrlen;
+    freeaddrinfo(info);
+    return true;
+}
+
+io_uring_sqe *IoUringEngine::nextSqe()
+{
+    // 队列已满时先提交已准备好的 SQE；提交失败后引擎停止，返回占位 SQE 供调用处写入
+    while (m_sqLocalTail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE) >= m_sqEntries) {
+        if (m_failed) {
+            memset(m_scratchSqe, 0, sizeof(*m_scratchSqe));
+            return m_scratchSqe;
+        }
+        int ret = submitAndWait(0);
+        if (ret < 0) {
+            fail(-ret);
+        }
+    }
+
+    unsigned index = m_sqLocalTail & *m_sqMask;
+    io_uring_sqe *sqe = &m_sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    m_sqArray[index] = index;
+    m_sqLocalTail++;
+    m_toSubmit++;
+    return sqe;
+}
+
+// 成功返回 0，失败返回 -errno
+int IoUringEngine::submitAndWait(unsigned minComplete)
+{
+    __atomic_store_n(m_sqTail, m_sqLocalTail, __ATOMIC_RELEASE);
+
+    unsigned flags = minComplete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    // 完成队列中已有事件时不需要等待
+    if (minComplete > 0 && __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE) != *m_cqHead) {
+        minComplete = 0;
+        if (m_toSubmit == 0) {
+            return 0;
+        }
+    }
+
+    int submitted = enter(m_toSubmit, minComplete, flags);
+    if (submitted < 0) {
+        return submitted;
+    }
+    m_toSubmit -= std::min<unsigned>(m_toSubmit, static_cast<unsigned>(submitted));
+    return 0;
+}
+
+int IoUringEngine::enter(unsigned toSubmit, unsigned minComplete, unsigned flags)
+{
+    for (;;) {
+        m_syscalls++;
+        long ret = syscall(__NR_io_uring_enter, m_ringFd, toSubmit, minComplete, flags, nullptr, 0);
+        if (ret >= 0) {
+            return static_cast<int>(ret);
+        }
+        if (errno != EINTR) {
+            return -errno;
+        }
+    }
+}
@@ -0,0 +1,119 @@
+#ifndef IOURINGENGINE_H
+#define IOURINGENGINE_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// 基于 io_uring 的批量文件发送引擎（仅 Linux）
+// 多个文件同时处于发送状态，打开、stat、连接、读取、发送、接收响应和关闭都以 SQE 的形式批量提交，
+// 文件与 socket 使用直接描述符（fixed files），文件数据读入预先注册的缓冲区。
+// 文件打开成功后才连接接收端，避免向接收端发起没有数据的连接
+class IoUringEngine
+{
+public:
+    struct Job {
+        uint64_t id = 0;
+        std::string path;       // 本地编码的文件路径
+        std::string fileName;   // UTF-8 文件名，写入文件头
+        std::string host;       // 数字形式的 IPv4/IPv6 地址，主机名由调用方解析，引擎线程不做 DNS 查询
+        uint16_t port = 0;
+    };
+
+    struct Result {
+        uint64_t id = 0;
+        bool success = false;
+        bool connectFailed = false; // 连接阶段失败，应归咎于接收端
+        bool fileFailed = false;    // 打开、stat 或读取文件失败
+        int error = 0;              // 失败时的 errno
+        std::string response;
+        int64_t bytes = 0;
+        int64_t connectMs = 0;
+        int64_t elapsedMs = 0;
+    };
+
+    IoUringEngine(unsigned slots, unsigned bufferSize, int connectTimeoutMs, int responseTimeoutMs);
+    ~IoUringEngine();
+
+    IoUringEngine(const IoUringEngine &) = delete;
+    IoUringEngine &operator=(const IoUringEngine &) = delete;
+
+    // 创建 io_uring、检查内核支持的操作并注册文件表与缓冲区
+    bool init(std::string &error);
+
+    // 不断从 nextJob 取文件填满空闲槽位，直到没有新文件且所有槽位空闲时返回。
+    // io_uring_enter 出现无法恢复的错误时提前返回，此后 failed() 为 true，在途文件的结果不再回报
+    void run(const std::function<bool(Job &)> &nextJob, const std::function<void(const Result &)> &onResult);
+
+    // 线程安全：唤醒阻塞在等待完成事件中的 run，使其立即为空闲槽位获取新文件
+    void wakeup();
+
+    bool failed() const { return m_failed; }
+    const std::string &errorString() const { return m_errorString; }
+    uint64_t syscalls() const { return m_syscalls; }
+    uint64_t filesCompleted() const { return m_filesCompleted; }
+
+private:
+    struct Slot;
+
+    void startSlot(unsigned index, const Job &job);
+    void handleCompletion(unsigned index, unsigned tag, int res);
+    void submitConnect(unsigned index);
+    void submitReadOrSend(unsigned index);
+    void submitClose(unsigned index);
+    void finishSlot(unsigned index);
+    bool parseAddress(unsigned index);
+    void armWakeup();
+    unsigned reapCompletions();
+    void fail(int error);
+
+    struct io_uring_sqe *nextSqe();
+    int submitAndWait(unsigned minComplete);
+    int enter(unsigned toSubmit, unsigned minComplete, unsigned flags);
+
+    unsigned m_slotCount;
+    unsigned m_bufferSize;
+    int m_connectTimeoutMs;
+    int m_responseTimeoutMs;
+
+    int m_ringFd = -1;
+    void *m_sqRing = nullptr;
+    void *m_cqRing = nullptr;
+    size_t m_sqRingSize = 0;
+    size_t m_cqRingSize = 0;
+    struct io_uring_sqe *m_sqes = nullptr;
+    size_t m_sqesSize = 0;
+
+    unsigned *m_sqHead = nullptr;
+    unsigned *m_sqTail = nullptr;
+    unsigned *m_sqMask = nullptr;
+    unsigned *m_sqArray = nullptr;
+    unsigned m_sqEntries = 0;
+    unsigned *m_cqHead = nullptr;
+    unsigned *m_cqTail = nullptr;
+    unsigned *m_cqMask = nullptr;
+    struct io_uring_cqe *m_cqes = nullptr;
+
+    unsigned m_sqLocalTail = 0;
+    unsigned m_toSubmit = 0;
+
+    char *m_buffers = nullptr;
+    std::vector<Slot> m_slots;
+    std::function<void(const Result &)> m_onResult;
+
+    // 唤醒用的 eventfd，等待完成事件期间始终挂着一个对它的读操作
+    int m_wakeupFd = -1;
+    bool m_wakeupArmed = false;
+    uint64_t m_wakeupValue = 0;
+
+    // 出错后 nextSqe 返回的占位 SQE，避免调用处逐一判断
+    struct io_uring_sqe *m_scratchSqe = nullptr;
+    bool m_failed = false;
+    std::string m_errorString;
+
+    uint64_t m_syscalls = 0;
+    uint64_t m_filesCompleted = 0;
+};
+
+#endif // IOURINGENGINE_H
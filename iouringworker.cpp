@@ -0,0 +1,140 @@
+#include "iouringworker.h"
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <cerrno>
+#include <cstring>
+#include "retryscheduler.h"
+
+// 同时处于发送状态的文件数与每个文件的注册缓冲区大小
+const unsigned IO_URING_SLOTS = 16;
+const unsigned IO_URING_BUFFER_SIZE = 256 * 1024;
+// 超时与 Qt 发送路径一致
+const int IO_URING_CONNECT_TIMEOUT_MS = 5000;
+const int IO_URING_RESPONSE_TIMEOUT_MS = 10000;
+// 每完成多少个文件刷新一次统计
+const quint64 STATISTICS_INTERVAL_FILES = 100;
+
+IoUringWorker::IoUringWorker(QObject *parent)
+    : QObject(parent)
+    , m_engine(IO_URING_SLOTS, IO_URING_BUFFER_SIZE, IO_URING_CONNECT_TIMEOUT_MS, IO_URING_RESPONSE_TIMEOUT_MS)
+{
+    std::string error;
+    m_available = m_engine.init(error);
+    if (!m_available) {
+        m_errorString = QString::fromStdString(error);
+        qDebug() << "io_uring 不可用：" << m_errorString;
+    }
+}
+
+void IoUringWorker::submit(quint64 id, const QString &filePath, const QString &host, quint16 port)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_failed) {
+        return;
+    }
+    bool wasEmpty = m_queue.isEmpty();
+    m_queue.enqueue({id, filePath, host, port});
+    if (!m_draining) {
+        m_draining = true;
+        QMetaObject::invokeMethod(this, "drain", Qt::QueuedConnection);
+    } else if (wasEmpty) {
+        // 引擎可能正阻塞在等待完成事件上，唤醒它取新文件；队列非空时引擎尚未取完，无需唤醒
+        m_engine.wakeup();
+    }
+}
+
+void IoUringWorker::stop()
+{
+    QMutexLocker locker(&m_mutex);
+    m_queue.clear();
+}
+
+// 持续从队列取文件交给引擎，直到队列为空且所有在途文件结束
+void IoUringWorker::drain()
+{
+    m_busyTimer.start();
+
+    for (;;) {
+        m_engine.run(
+            [this](IoUringEngine::Job &job) {
+                QMutexLocker locker(&m_mutex);
+                if (m_queue.isEmpty()) {
+                    return false;
+                }
+                PendingJob pending = m_queue.dequeue();
+                job.id = pending.id;
+                job.path = QFile::encodeName(pending.filePath).toStdString();
+                job.fileName = QFileInfo(pending.filePath).fileName().toUtf8().toStdString();
+                job.host = pending.host.toStdString();
+                job.port = pending.port;
+                return true;
+            },
+            [this](const IoUringEngine::Result &result) { reportResult(result); });
+
+        // 引擎返回与新文件入队之间存在竞争，清除标志前再检查一次
+        QMutexLocker locker(&m_mutex);
+        if (m_engine.failed()) {
+            m_failed = true;
+            m_queue.clear();
+            m_draining = false;
+            break;
+        }
+        if (m_queue.isEmpty()) {
+            m_draining = false;
+            break;
+        }
+    }
+
+    m_busyMs += m_busyTimer.elapsed();
+    m_busyTimer.invalidate();
+    reportStatistics();
+
+    if (m_failed) {
+        qDebug() << "io_uring 引擎出错：" << QString::fromStdString(m_engine.errorString());
+        emit engineFailed(QString::fromStdString(m_engine.errorString()));
+    }
+}
+
+void IoUringWorker::reportResult(const IoUringEngine::Result &result)
+{
+    QString response = QString::fromUtf8(result.response.data(), static_cast<int>(result.response.size()));
+    QString error;
+    RetryScheduler::ErrorClass errorClass = RetryScheduler::Other;
+
+    if (!result.success) {
+        if (result.error != 0) {
+            error = QString::fromLocal8Bit(strerror(result.error));
+        } else {
+            error = QString("服务器响应：%1").arg(response);
+        }
+
+        if (result.fileFailed) {
+            errorClass = RetryScheduler::Other;
+        } else if (result.error == ETIME || result.error == ETIMEDOUT) {
+            errorClass = RetryScheduler::Timeout;
+        } else if (result.error == ECONNRESET || result.error == EPIPE) {
+            errorClass = RetryScheduler::ConnectionReset;
+        } else if (result.error == ECONNREFUSED) {
+            errorClass = RetryScheduler::ConnectionRefused;
+        } else if (response == "FAILURE") {
+            errorClass = RetryScheduler::ServerFailure;
+        }
+    }
+
+    emit fileFinished(result.id, result.success, result.connectFailed, result.fileFailed, errorClass,
+                      error, result.bytes, result.connectMs, result.elapsedMs);
+
+    if (m_engine.filesCompleted() % STATISTICS_INTERVAL_FILES == 0) {
+        reportStatistics();
+    }
+}
+
+void IoUringWorker::reportStatistics()
+{
+    quint64 files = m_engine.filesCompleted();
+    qint64 busyMs = m_busyMs + (m_busyTimer.isValid() ? m_busyTimer.elapsed() : 0);
+    double filesPerSecond = busyMs > 0 ? files * 1000.0 / busyMs : 0.0;
+    emit statisticsChanged(files, m_engine.syscalls(), filesPerSecond);
+}
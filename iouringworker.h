@@ -0,0 +1,64 @@
+#ifndef IOURINGWORKER_H
+#define IOURINGWORKER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QQueue>
+#include <QString>
+#include "iouringengine.h"
+
+// 在独立线程中驱动 io_uring 发送引擎：主线程提交文件，工作线程批量发送并逐个回报结果
+class IoUringWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit IoUringWorker(QObject *parent = nullptr);
+
+    // 内核不支持 io_uring 或所需操作时不可用，此时应使用 Qt 发送路径
+    bool isAvailable() const { return m_available; }
+    QString errorString() const { return m_errorString; }
+
+    // 线程安全：把文件加入发送队列，工作线程空闲时开始处理，正在发送时唤醒引擎；引擎出错后忽略
+    void submit(quint64 id, const QString &filePath, const QString &host, quint16 port);
+    // 线程安全：丢弃尚未开始的文件，正在发送的文件在超时内结束
+    void stop();
+
+signals:
+    // errorClass 为 RetryScheduler::ErrorClass
+    void fileFinished(quint64 id, bool success, bool connectFailed, bool fileFailed, int errorClass,
+                      const QString &error, qint64 bytes, qint64 connectMs, qint64 elapsedMs);
+    void statisticsChanged(quint64 files, quint64 syscalls, double filesPerSecond);
+    // io_uring_enter 出现无法恢复的错误，引擎停止；尚未回报结果的文件不会再有 fileFinished
+    void engineFailed(const QString &error);
+
+private slots:
+    void drain();
+
+private:
+    struct PendingJob {
+        quint64 id;
+        QString filePath;
+        QString host;
+        quint16 port;
+    };
+
+    void reportResult(const IoUringEngine::Result &result);
+    void reportStatistics();
+
+    IoUringEngine m_engine;
+    bool m_available = false;
+    QString m_errorString;
+
+    QMutex m_mutex;
+    QQueue<PendingJob> m_queue;
+    bool m_draining = false;
+    bool m_failed = false;
+
+    // 引擎实际运行的累计时间，用于计算 files/sec，空闲等待不计入
+    QElapsedTimer m_busyTimer;
+    qint64 m_busyMs = 0;
+};
+
+#endif // IOURINGWORKER_H
@@ -8,11 +8,23 @@
 #include <QFileInfo>
 #include <QFileDialog>
 #include <QTimer>
+#include <QThread>
+#include <QHostInfo>
+#include <QDateTime>
+#include <algorithm>
+#include <functional>
 #include "logmanager.h"
-
-// 定义重试常量
-const int MAX_RETRIES = 5;
-const int RETRY_DELAY_MS = 2000;
+#ifdef TCPCLIENT_HAVE_IO_URING
+#include "iouringworker.h"
+#endif
+
+// 连接接收端和等待服务器响应的超时时间（重试策略见 retryscheduler.cpp）
+const int CONNECT_TIMEOUT_MS = 5000;
+const int RESPONSE_TIMEOUT_MS = 10000;
+// io_uring 引擎内部并发发送多个文件，每个接收端至少放行该数量的文件
+const int IO_URING_STREAMS_PER_ENDPOINT = 16;
+// io_uring 引擎使用的主机名解析结果的缓存时间
+const qint64 HOST_CACHE_MS = 60000;
 QString folderPath = "E:/AIR/小长ISAR/实时数据回传/data";
 
 QString ipAddress = "127.0.0.1";
@@ -23,7 +35,7 @@ MainWindow::MainWindow(QWidget *parent)
     , ui(new Ui::MainWindow)
 {
     ui->setupUi(this);
-    ui->ipAddressLineEdit->setPlaceholderText("请输入 IP 地址");
+    ui->ipAddressLineEdit->setPlaceholderText("请输入 IP 地址，多个接收端以逗号分隔，如 host:port*权重");
     ui->portLineEdit->setPlaceholderText("请输入端口号");
     ui->pathLineEdit->setPlaceholderText("请输入监控文件夹路径"); // ✅ 设置路径编辑框占位符
     ui->pathLineEdit->setText(folderPath); // ✅ 将硬编码路径设为默认值
@@ -33,9 +45,69 @@ MainWindow::MainWindow(QWidget *parent)
     myFileSystemWatcher = new QFileSystemWatcher(this);
     connect(myFileSystemWatcher, &QFileSystemWatcher::directoryChanged, this, &MainWindow::onDirectoryChanged);
 
+    // 接收端管理：负载均衡、故障转移与熔断
+    m_endpointManager = new EndpointManager(this);
+    connect(m_endpointManager, &EndpointManager::endpointAvailable, this, &MainWindow::startFileTransfer);
+    connect(m_endpointManager, &EndpointManager::statisticsChanged, this, &MainWindow::updateEndpointStatistics);
+
+    // 集中的重试调度：按错误类型指数退避
+    m_retryScheduler = new RetryScheduler(this);
+    connect(m_retryScheduler, &RetryScheduler::retryReady, this, &MainWindow::onRetryReady);
+
+    // 传输参数调优：默认自动，取消勾选后使用界面上的手动设置
+    m_transferTuner = new TransferTuner(this);
+    connect(m_transferTuner, &TransferTuner::tuningChanged, this, &MainWindow::onTuningChanged);
+    connect(m_transferTuner, &TransferTuner::statisticsChanged, this, &MainWindow::updateTuningStatistics);
+    connect(ui->autoTuneCheckBox, &QCheckBox::toggled, this, &MainWindow::applyManualTuning);
+    connect(ui->chunkSizeSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &MainWindow::applyManualTuning);
+    connect(ui->sendBufferSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &MainWindow::applyManualTuning);
+    connect(ui->highWaterMarkSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &MainWindow::applyManualTuning);
+    connect(ui->lowWaterMarkSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &MainWindow::applyManualTuning);
+    connect(ui->streamsSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &MainWindow::applyManualTuning);
+    applyManualTuning();
+
     updateStatistics();
 
     qRegisterMetaType<qint64>("qint64");
+    qRegisterMetaType<DispositionPolicy>("DispositionPolicy");
+
+    // 传输后处理在独立线程中执行，避免文件移动阻塞界面和发送队列
+    m_dispositionThread = new QThread(this);
+    DispositionWorker *dispositionWorker = new DispositionWorker;
+    dispositionWorker->moveToThread(m_dispositionThread);
+    connect(m_dispositionThread, &QThread::finished, dispositionWorker, &QObject::deleteLater);
+    connect(this, &MainWindow::dispositionRequested, dispositionWorker, &DispositionWorker::dispose);
+    connect(dispositionWorker, &DispositionWorker::disposed, this, &MainWindow::onFileDisposed);
+    m_dispositionThread->start();
+
+#ifdef TCPCLIENT_HAVE_IO_URING
+    // io_uring 批量发送引擎同样在独立线程中运行，内核不支持时禁用该选项
+    qRegisterMetaType<quint64>("quint64");
+    IoUringWorker *ioUringWorker = new IoUringWorker;
+    if (ioUringWorker->isAvailable()) {
+        m_ioUringWorker = ioUringWorker;
+        m_ioUringThread = new QThread(this);
+        m_ioUringWorker->moveToThread(m_ioUringThread);
+        connect(m_ioUringThread, &QThread::finished, m_ioUringWorker, &QObject::deleteLater);
+        connect(m_ioUringWorker, &IoUringWorker::fileFinished, this, &MainWindow::onIoUringFileFinished);
+        connect(m_ioUringWorker, &IoUringWorker::statisticsChanged, this, &MainWindow::onIoUringStatistics);
+        connect(m_ioUringWorker, &IoUringWorker::engineFailed, this, &MainWindow::onIoUringEngineFailed);
+        m_ioUringThread->start();
+    } else {
+        ui->ioUringCheckBox->setEnabled(false);
+        ui->ioUringCheckBox->setToolTip("io_uring 不可用：" + ioUringWorker->errorString());
+        delete ioUringWorker;
+    }
+#else
+    ui->ioUringCheckBox->hide();
+#endif
+    connect(ui->ioUringCheckBox, &QCheckBox::toggled, this, [this](bool checked) {
+        qDebug() << "发送引擎切换为" << (checked ? "io_uring 批量发送" : "Qt");
+        applyStreamLimit();
+        updateIoEngineStatistics();
+        startFileTransfer();
+    });
+    updateIoEngineStatistics();
 
     // 已经自动连接了，所以不需要手动连接
     // connect(ui->pushButton, &QPushButton::clicked, this, &MainWindow::on_pushButton_clicked, Qt::UniqueConnection);
@@ -53,6 +125,16 @@ MainWindow::MainWindow(QWidget *parent)
 
 MainWindow::~MainWindow()
 {
+#ifdef TCPCLIENT_HAVE_IO_URING
+    // 丢弃尚未开始的文件，等待在途文件在超时内结束
+    if (m_ioUringThread) {
+        m_ioUringWorker->stop();
+        m_ioUringThread->quit();
+        m_ioUringThread->wait();
+    }
+#endif
+    m_dispositionThread->quit();
+    m_dispositionThread->wait();
     delete ui;
 }
 
@@ -115,16 +197,27 @@ void MainWindow::onSocketError(QAbstractSocket::SocketError socketError)
 // “开始监控”按钮的槽函数
 void MainWindow::on_pushButton_clicked()
 {
-    // 获取用户输入的IP地址和端口号
-    ipAddress = ui->ipAddressLineEdit->text();
-    port = ui->portLineEdit->text().toUShort();
+    // 获取用户输入的接收端列表和默认端口号
+    quint16 defaultPort = ui->portLineEdit->text().toUShort();
+    QList<Endpoint> endpoints = EndpointManager::parseEndpoints(ui->ipAddressLineEdit->text(), defaultPort);
 
     // 检查IP地址和端口号是否有效
-    if (ipAddress.isEmpty() || port == 0) {
+    if (endpoints.isEmpty()) {
         qDebug() << "请正确填写IP地址与端口号！";
         return;
     }
 
+    // 第一个接收端同时用于消息发送
+    ipAddress = endpoints.first().host;
+    port = endpoints.first().port;
+
+    // 传输进行中时不替换接收端列表，避免正在使用的接收端索引失效
+    if (m_transfers.isEmpty() && m_ioUringJobs.isEmpty()) {
+        m_endpointManager->setEndpoints(endpoints);
+    } else {
+        qDebug() << "存在正在进行的传输，接收端列表未更新。";
+    }
+
     folderPath = ui->pathLineEdit->text();
 
     // 检查路径是否已在监控列表中，以防止重复添加
@@ -132,6 +225,11 @@ void MainWindow::on_pushButton_clicked()
         if (QDir(folderPath).exists()) {
             myFileSystemWatcher->addPath(folderPath);
             qDebug() << "已成功添加监控路径：" << folderPath;
+
+            // 记录该监控目录的传输后处理策略
+            DispositionPolicy::Action action = static_cast<DispositionPolicy::Action>(ui->dispositionComboBox->currentIndex());
+            m_dispositionPolicies.insert(QDir::cleanPath(folderPath), DispositionPolicy::defaultsFor(folderPath, action));
+            qDebug() << "发送成功后的处理方式：" << DispositionPolicy::actionName(action);
         } else {
             qDebug() << "错误：指定的监控路径不存在：" << folderPath;
             QMessageBox::warning(this, "警告", "指定的监控文件夹不存在。");
@@ -199,65 +297,93 @@ void MainWindow::onDirectoryChanged(const QString &path)
     startFileTransfer(); // 启动文件传输队列
 }
 
-// 封装了文件传输和重试逻辑的槽函数
+// 封装了文件传输和重试逻辑的槽函数：从队列中取文件分派给空闲的接收端
 void MainWindow::startFileTransfer()
 {
-    // 如果正在发送文件或者队列为空，则不执行任何操作
-    if (m_isSendingFile || m_pendingFiles.isEmpty()) {
-        return;
-    }
-
-    m_isSendingFile = true; // 标记正在发送文件
-    QString filePath = m_pendingFiles.dequeue(); // 从队列中取出下一个文件
+    while (!m_pendingFiles.isEmpty()) {
+        // 选择负载最低的在线接收端，全部繁忙或熔断时暂停整个队列
+        int endpoint = m_endpointManager->acquire();
+        if (endpoint < 0) {
+            m_transferTuner->setBacklogged(true);
+            return;
+        }
 
-    // 获取当前文件的重试次数
-    int currentRetry = m_fileRetries.value(filePath, 0);
+#ifdef TCPCLIENT_HAVE_IO_URING
+        if (ioUringEnabled()) {
+            // 引擎只接受数字地址；主机名尚未解析时暂停队列，解析完成后再继续
+            const Endpoint &target = m_endpointManager->endpoint(endpoint);
+            QString address = ioUringAddress(target.host);
+            if (address.isEmpty()) {
+                m_endpointManager->release(endpoint);
+                return;
+            }
 
-    // 检查是否超出最大重试次数
-    if (currentRetry >= MAX_RETRIES) {
-        qDebug() << "\033[31m文件" << QFileInfo(filePath).fileName() << "传输失败：已达到最大重试次数，放弃传输。\033[0m";
-        m_fileRetries.remove(filePath); // 清除重试记录
-        m_fileStatus[filePath] = Failure; // 将文件状态标记为失败
-        updateStatistics(); // 更新统计数据
-        m_isSendingFile = false; // 传输结束
-        startFileTransfer(); // 尝试发送下一个文件
-        return;
+            // 交给 io_uring 引擎批量发送，结果由 onIoUringFileFinished 处理
+            QString filePath = m_pendingFiles.dequeue();
+            quint64 id = ++m_nextIoUringJobId;
+            m_ioUringJobs.insert(id, {filePath, endpoint});
+            m_transferTuner->setActiveTransfers(m_transfers.size() + m_ioUringJobs.size());
+            m_ioUringWorker->submit(id, filePath, address, target.port);
+            updateTransferProgress();
+            continue;
+        }
+#endif
+        QString filePath = m_pendingFiles.dequeue();
+        if (!beginTransfer(filePath, endpoint)) {
+            m_endpointManager->release(endpoint);
+        }
     }
+    m_transferTuner->setBacklogged(false);
+}
 
-    // 为每个文件创建一个独立的连接
-    QTcpSocket* socket = new QTcpSocket(this);
+// 建立到指定接收端的连接并开始发送文件
+bool MainWindow::beginTransfer(const QString &filePath, int endpoint)
+{
     QFile* file = new QFile(filePath);
 
     // 尝试打开文件
     if (!file->open(QIODevice::ReadOnly)) {
-        m_fileRetries.insert(filePath, currentRetry + 1); // 增加重试次数
         delete file;
-        socket->deleteLater();
-        m_isSendingFile = false; // 传输结束
-        QTimer::singleShot(RETRY_DELAY_MS, [this, filePath](){
-            // 将文件重新放回队列，等待下次发送
-            m_pendingFiles.enqueue(filePath);
-            startFileTransfer();
-        });
-        return;
+        retryLater(filePath, RetryScheduler::Other);
+        return false;
     }
 
-    // 记录文件大小和启动计时器
-    m_fileSize = file->size();
-    m_bytesWrittenTotal = 0;
-    m_speedTimer.start();
+    // 为每个文件创建一个独立的连接
+    QTcpSocket* socket = new QTcpSocket(this);
+
+    FileTransfer *transfer = new FileTransfer;
+    transfer->filePath = filePath;
+    transfer->endpoint = endpoint;
+    transfer->socket = socket;
+    transfer->file = file;
+    transfer->fileSize = file->size();
+    transfer->timer.start();
+    if (m_transfers.isEmpty()) {
+        m_qtBusyTimer.start();
+    }
+    m_transfers.insert(socket, transfer);
+    m_transferTuner->setActiveTransfers(m_transfers.size() + m_ioUringJobs.size());
 
     // 成功打开文件，设置连接信号
     connect(socket, &QTcpSocket::connected, this, [=]() {
-        if (ui->label_currentFile) {
-            ui->label_currentFile->setText(QString("正在发送: %1").arg(QFileInfo(filePath).fileName()));
+        FileTransfer *t = m_transfers.value(socket);
+        if (!t) {
+            return;
         }
+        t->connected = true;
+        m_endpointManager->reportConnected(t->endpoint);
+        // 建立连接的耗时作为 RTT 样本
+        m_transferTuner->addRttSample(t->timer.elapsed());
+        int sendBufferSize = m_transferTuner->tuning().sendBufferSize;
+        if (sendBufferSize > 0) {
+            socket->setSocketOption(QAbstractSocket::SendBufferSizeSocketOption, sendBufferSize);
+        }
+        updateTransferProgress();
 
         // 构造并发送文件头
-        QByteArray fileNameBytes = QFileInfo(*file).fileName().toUtf8();
+        QByteArray fileNameBytes = QFileInfo(*t->file).fileName().toUtf8();
         qint32 fileNameLength = fileNameBytes.size();
-        qint64 fileSize = file->size();
-        QByteArray fileSizeHeader = QString("%1").arg(fileSize, 16, 10, QChar(' ')).toUtf8();
+        QByteArray fileSizeHeader = QString("%1").arg(t->fileSize, 16, 10, QChar(' ')).toUtf8();
 
         QByteArray outputBlock;
         outputBlock.append(reinterpret_cast<const char*>(&fileNameLength), sizeof(qint32));
@@ -265,96 +391,493 @@ void MainWindow::startFileTransfer()
         outputBlock.append(fileSizeHeader);
 
         socket->write(outputBlock);
+        // 文件头之后立即把写缓冲填充到高水位，不等待 bytesWritten
+        fillSocket(socket);
     });
 
     // 新增：更新进度条和速度
     connect(socket, &QTcpSocket::bytesWritten, this, [=](qint64 bytes) {
-        m_bytesWrittenTotal += bytes;
-        qint64 totalBytes = m_fileSize;
-
-        if (totalBytes > 0) {
-            int percentage = (static_cast<double>(m_bytesWrittenTotal) / totalBytes) * 100;
-            if (ui->progressBar) {
-                ui->progressBar->setValue(percentage);
-            }
+        FileTransfer *t = m_transfers.value(socket);
+        if (!t) {
+            return;
+        }
+        m_transferTuner->addBytes(bytes);
 
-            double elapsedTime = m_speedTimer.elapsed() / 1000.0;
-            if (elapsedTime > 0) {
-                double speed = m_bytesWrittenTotal / (1024.0 * 1024.0 * elapsedTime);
-                if (ui->label_speed) {
-                    ui->label_speed->setText(QString("%1 MB/s").arg(speed, 0, 'f', 2));
-                }
-            }
+        // 写缓冲低于低水位时补充数据
+        if (socket->bytesToWrite() < m_transferTuner->tuning().lowWaterMark && !fillSocket(socket)) {
+            return;
         }
 
-        if (file->pos() < totalBytes) {
-            qint64 bytesToWrite = totalBytes - file->pos();
-            qint64 chunk = qMin(bytesToWrite, (qint64)64 * 1024);
-            QByteArray outputBlock = file->read(chunk);
-            socket->write(outputBlock);
+        // 进度按已交给内核的文件数据计算：已读出的数据减去仍在 Qt 写缓冲中的部分，文件头先于文件数据写出，不计入进度
+        t->bytesWritten = qBound<qint64>(0, t->file->pos() - socket->bytesToWrite(), t->fileSize);
+
+        // 数据全部写出后开始等待服务器响应
+        if (!t->awaitingResponse && t->file->pos() >= t->fileSize && socket->bytesToWrite() == 0) {
+            t->awaitingResponse = true;
+            QTimer::singleShot(RESPONSE_TIMEOUT_MS, socket, [=]() {
+                FileTransfer *t = m_transfers.value(socket);
+                if (!t) {
+                    return;
+                }
+                qDebug() << "\033[31m等待服务器响应超时，文件" << QFileInfo(filePath).fileName() << "\033[0m";
+                m_endpointManager->reportError(t->endpoint);
+                finishTransfer(socket);
+                retryLater(filePath, RetryScheduler::Timeout);
+            });
         }
+        updateTransferProgress();
     });
 
     connect(socket, &QTcpSocket::readyRead, this, [=]() {
+        FileTransfer *t = m_transfers.value(socket);
+        if (!t) {
+            return;
+        }
+        // 无论成功与否，收到服务器响应后都断开连接，文件关闭后再执行归档、重试或隔离
         QByteArray response = socket->readAll();
         if (response == "SUCCESS") {
-            qDebug() << "\033[32m服务器确认文件" << file->fileName() << "接收成功。\033[0m";
-            m_fileRetries.remove(filePath); // 成功后清除重试记录
+            qDebug() << "\033[32m服务器" << m_endpointManager->endpoint(t->endpoint).address() << "确认文件" << t->file->fileName() << "接收成功。\033[0m";
+            m_retryScheduler->clear(filePath); // 成功后清除重试记录
             m_fileStatus[filePath] = Success; // 将文件状态标记为成功
+            m_endpointManager->reportSuccess(t->endpoint, t->fileSize, t->timer.elapsed());
             updateStatistics(); // 更新统计数据
+            finishTransfer(socket);
+            disposeFile(filePath);
         } else if (response == "FAILURE") {
-            qDebug() << "\033[31m服务器返回失败，文件" << file->fileName() << "未成功接收。\033[0m";
-            m_fileStatus[filePath] = Failure; // 将文件状态标记为失败
-            updateStatistics();
+            qDebug() << "\033[31m服务器返回失败，文件" << t->file->fileName() << "未成功接收。\033[0m";
+            // 服务器能够响应，说明接收端在线，不计入熔断
+            m_endpointManager->reportError(t->endpoint, false);
+            finishTransfer(socket);
+            retryLater(filePath, RetryScheduler::ServerFailure);
         } else {
             qDebug() << "接收到未知服务器响应：" << response;
+            m_endpointManager->reportError(t->endpoint);
+            finishTransfer(socket);
+            retryLater(filePath, RetryScheduler::Other);
         }
-        // 无论成功与否，收到服务器响应后都断开连接
-        socket->disconnectFromHost();
     });
 
-    // 处理连接错误并加入重试机制
+    // 处理连接错误：连接阶段失败时熔断接收端，传输中失败时按错误类型重试
     connect(socket, QOverload<QAbstractSocket::SocketError>::of(&QTcpSocket::errorOccurred), this, [=](QAbstractSocket::SocketError socketError) {
-        Q_UNUSED(socketError);
-        // 如果是连接拒绝，并且没有达到最大重试次数，则进行重试
-        if (socketError == QAbstractSocket::ConnectionRefusedError && m_fileRetries.value(filePath, 0) < MAX_RETRIES) {
-            m_fileRetries.insert(filePath, m_fileRetries.value(filePath, 0) + 1); // 增加重试次数
-            file->close();
-            delete file;
-            socket->deleteLater();
-            m_isSendingFile = false; // 传输结束
-            QTimer::singleShot(RETRY_DELAY_MS, [this, filePath](){
-                // 将文件重新放回队列，等待下次发送
-                m_pendingFiles.enqueue(filePath);
-                startFileTransfer();
-            });
+        FileTransfer *t = m_transfers.value(socket);
+        if (!t) {
+            return;
+        }
+        if (!t->connected) {
+            // 接收端不可用：熔断，文件放回队首由其他接收端接管，不消耗重试次数
+            m_endpointManager->reportConnectFailure(t->endpoint, socket->errorString());
+            m_pendingFiles.prepend(filePath);
+            finishTransfer(socket);
         } else {
-            qDebug() << "\033[31m连接错误：" << socket->errorString() << "，已达到最大重试次数，放弃传输。\033[0m";
-            file->close();
-            delete file;
-            socket->disconnectFromHost();
+            qDebug() << "\033[31m连接错误：" << socket->errorString() << "，文件" << QFileInfo(filePath).fileName() << "\033[0m";
+            m_endpointManager->reportError(t->endpoint);
+            finishTransfer(socket);
+            retryLater(filePath, RetryScheduler::classify(socketError));
         }
     });
 
     connect(socket, &QTcpSocket::disconnected, this, [=]() {
+        FileTransfer *t = m_transfers.value(socket);
+        if (!t) {
+            return;
+        }
+        // 在收到服务器响应前连接被断开
+        qDebug() << "\033[31m连接在收到服务器响应前断开，文件" << QFileInfo(filePath).fileName() << "\033[0m";
+        m_endpointManager->reportError(t->endpoint);
+        finishTransfer(socket);
+        retryLater(filePath, RetryScheduler::ConnectionReset);
+    });
+
+    // 连接超时同样视为接收端不可用
+    QTimer::singleShot(CONNECT_TIMEOUT_MS, socket, [=]() {
+        FileTransfer *t = m_transfers.value(socket);
+        if (!t || t->connected) {
+            return;
+        }
+        m_endpointManager->reportConnectFailure(t->endpoint, "连接超时");
+        m_pendingFiles.prepend(filePath);
+        finishTransfer(socket);
+    });
+
+    const Endpoint &target = m_endpointManager->endpoint(endpoint);
+    socket->connectToHost(target.host, target.port);
+    return true;
+}
+
+// 从文件读取数据，把 socket 写缓冲填充到高水位；读取失败时结束传输并返回 false
+bool MainWindow::fillSocket(QTcpSocket *socket)
+{
+    FileTransfer *t = m_transfers.value(socket);
+    if (!t) {
+        return false;
+    }
+
+    const TransferTuning tuning = m_transferTuner->tuning();
+    while (t->file->pos() < t->fileSize && socket->bytesToWrite() < tuning.highWaterMark) {
+        qint64 chunk = qMin(t->fileSize - t->file->pos(), (qint64)tuning.chunkSize);
+        QByteArray outputBlock = t->file->read(chunk);
+        if (outputBlock.isEmpty()) {
+            qDebug() << "\033[31m读取文件失败：" << t->file->errorString() << "，文件" << QFileInfo(t->filePath).fileName() << "\033[0m";
+            QString filePath = t->filePath;
+            finishTransfer(socket);
+            retryLater(filePath, RetryScheduler::Other);
+            return false;
+        }
+
+        qint64 written = socket->write(outputBlock);
+        if (written < 0) {
+            // 写入失败由 errorOccurred 处理
+            return false;
+        }
+        if (written < outputBlock.size()) {
+            // 部分写入：把文件位置退回到未写入的数据处，下次补充时重新读取
+            t->file->seek(t->file->pos() - (outputBlock.size() - written));
+            break;
+        }
+    }
+    return true;
+}
+
+// 结束一次传输：释放文件、socket 与接收端槽位，然后继续分派队列
+void MainWindow::finishTransfer(QTcpSocket *socket)
+{
+    FileTransfer *transfer = m_transfers.take(socket);
+    if (!transfer) {
+        return;
+    }
+    m_transferTuner->setActiveTransfers(m_transfers.size() + m_ioUringJobs.size());
+
+    // 先断开所有信号，避免断开连接时再次进入处理函数
+    socket->disconnect(this);
+    socket->disconnectFromHost();
+    socket->deleteLater();
+
+    transfer->file->close();
+    delete transfer->file;
+    m_endpointManager->release(transfer->endpoint);
+    delete transfer;
+
+    m_qtFilesDone++;
+    if (m_transfers.isEmpty()) {
+        m_qtBusyMs += m_qtBusyTimer.elapsed();
+        m_qtBusyTimer.invalidate();
+    }
+    updateIoEngineStatistics();
+    updateTransferProgress();
+    startFileTransfer(); // 尝试发送下一个文件
+}
+
+// 交给重试调度器按错误类型退避重试，超出重试次数时标记为失败并隔离
+void MainWindow::retryLater(const QString &filePath, RetryScheduler::ErrorClass errorClass)
+{
+    if (!m_retryScheduler->schedule(filePath, errorClass)) {
+        m_fileStatus[filePath] = Failure; // 将文件状态标记为失败
+        updateStatistics(); // 更新统计数据
+        disposeFile(filePath); // 移入隔离目录
+    }
+}
+
+// 重试时间到达，将文件重新放回队列
+void MainWindow::onRetryReady(const QString &filePath)
+{
+    m_pendingFiles.enqueue(filePath);
+    startFileTransfer();
+}
+
+// 汇总所有正在进行的传输，更新进度条、速度和当前文件显示
+void MainWindow::updateTransferProgress()
+{
+    if (m_transfers.isEmpty()) {
         // 文件发送完成后，重置进度显示
         if (ui->progressBar) {
             ui->progressBar->setValue(0);
         }
         if (ui->label_currentFile) {
-            ui->label_currentFile->setText("无文件发送");
+            ui->label_currentFile->setText(m_ioUringJobs.isEmpty()
+                                               ? QString("无文件发送")
+                                               : QString("io_uring 批量发送中：%1 个文件").arg(m_ioUringJobs.size()));
         }
         if (ui->label_speed) {
             ui->label_speed->setText("0.00 MB/s");
         }
-        delete file;
-        socket->deleteLater();
-        m_isSendingFile = false; // 传输结束
-        startFileTransfer(); // 尝试发送下一个文件
-    });
+        return;
+    }
 
-    // 修正：确保客户端连接的端口与服务器监听的端口一致
-    socket->connectToHost(ipAddress, port);
+    qint64 totalBytes = 0;
+    qint64 sentBytes = 0;
+    double speed = 0.0;
+    QStringList sendingFiles;
+
+    for (const FileTransfer *t : m_transfers) {
+        totalBytes += t->fileSize;
+        sentBytes += qMin(t->bytesWritten, t->fileSize);
+        double elapsedTime = t->timer.elapsed() / 1000.0;
+        if (elapsedTime > 0) {
+            speed += t->bytesWritten / (1024.0 * 1024.0 * elapsedTime);
+        }
+        if (t->connected) {
+            sendingFiles << QFileInfo(t->filePath).fileName();
+        }
+    }
+
+    if (ui->progressBar && totalBytes > 0) {
+        ui->progressBar->setValue(static_cast<int>(sentBytes * 100 / totalBytes));
+    }
+    if (ui->label_currentFile) {
+        if (sendingFiles.isEmpty()) {
+            ui->label_currentFile->setText("正在连接接收端...");
+        } else if (sendingFiles.size() == 1) {
+            ui->label_currentFile->setText(QString("正在发送: %1").arg(sendingFiles.first()));
+        } else {
+            ui->label_currentFile->setText(QString("正在发送: %1 等 %2 个文件").arg(sendingFiles.first()).arg(sendingFiles.size()));
+        }
+    }
+    if (ui->label_speed) {
+        ui->label_speed->setText(QString("%1 MB/s").arg(speed, 0, 'f', 2));
+    }
+}
+
+// 刷新各接收端的吞吐量与错误统计
+void MainWindow::updateEndpointStatistics()
+{
+    if (ui->label_endpoints) {
+        ui->label_endpoints->setText(m_endpointManager->statisticsText());
+    }
+}
+
+// 传输参数变化后更新每个接收端的并发数，并用新增的槽位继续分派
+void MainWindow::onTuningChanged(const TransferTuning &tuning)
+{
+    Q_UNUSED(tuning);
+    applyStreamLimit();
+    updateTuningStatistics();
+    startFileTransfer();
+}
+
+// 读取界面上的调优模式和手动参数
+void MainWindow::applyManualTuning()
+{
+    bool autoTune = ui->autoTuneCheckBox->isChecked();
+    ui->chunkSizeSpinBox->setEnabled(!autoTune);
+    ui->sendBufferSpinBox->setEnabled(!autoTune);
+    ui->highWaterMarkSpinBox->setEnabled(!autoTune);
+    ui->lowWaterMarkSpinBox->setEnabled(!autoTune);
+    ui->streamsSpinBox->setEnabled(!autoTune);
+
+    TransferTuning tuning;
+    tuning.chunkSize = ui->chunkSizeSpinBox->value() * 1024;
+    tuning.sendBufferSize = ui->sendBufferSpinBox->value() * 1024;
+    tuning.highWaterMark = ui->highWaterMarkSpinBox->value() * 1024;
+    // 低水位不能高于高水位
+    tuning.lowWaterMark = qMin(ui->lowWaterMarkSpinBox->value() * 1024, tuning.highWaterMark);
+    tuning.streamsPerEndpoint = ui->streamsSpinBox->value();
+    m_transferTuner->setManualTuning(tuning);
+    m_transferTuner->setMode(autoTune ? TransferTuner::Auto : TransferTuner::Manual);
+    updateTuningStatistics();
+}
+
+void MainWindow::updateTuningStatistics()
+{
+    if (ui->label_tuning) {
+        ui->label_tuning->setText(m_transferTuner->statisticsText());
+    }
+}
+
+// 每个接收端的并发数：Qt 路径使用调优结果，io_uring 引擎至少放行足够多的文件以填满批次
+void MainWindow::applyStreamLimit()
+{
+    int streams = m_transferTuner->tuning().streamsPerEndpoint;
+    if (ioUringEnabled()) {
+        streams = qMax(streams, IO_URING_STREAMS_PER_ENDPOINT);
+    }
+    m_endpointManager->setMaxStreams(streams);
+}
+
+bool MainWindow::ioUringEnabled() const
+{
+    return m_ioUringWorker && ui->ioUringCheckBox->isChecked();
+}
+
+// io_uring 引擎回报一个文件的结果，与 Qt 发送路径共用状态、重试、熔断与后处理逻辑
+void MainWindow::onIoUringFileFinished(quint64 id, bool success, bool connectFailed, bool fileFailed, int errorClass,
+                                       const QString &error, qint64 bytes, qint64 connectMs, qint64 elapsedMs)
+{
+    if (!m_ioUringJobs.contains(id)) {
+        return;
+    }
+    IoUringJob job = m_ioUringJobs.take(id);
+    m_transferTuner->setActiveTransfers(m_transfers.size() + m_ioUringJobs.size());
+    QString fileName = QFileInfo(job.filePath).fileName();
+
+    if (connectFailed) {
+        // 接收端不可用：熔断，文件放回队首由其他接收端接管，不消耗重试次数
+        m_endpointManager->reportConnectFailure(job.endpoint, error);
+        m_endpointManager->release(job.endpoint);
+        m_pendingFiles.prepend(job.filePath);
+    } else if (fileFailed) {
+        // 文件读取失败与接收端无关
+        qDebug() << "\033[31m读取文件失败：" << error << "，文件" << fileName << "\033[0m";
+        m_endpointManager->release(job.endpoint);
+        retryLater(job.filePath, RetryScheduler::Other);
+    } else {
+        m_endpointManager->reportConnected(job.endpoint);
+        m_transferTuner->addRttSample(connectMs);
+        m_transferTuner->addBytes(bytes);
+
+        if (success) {
+            qDebug() << "\033[32m服务器" << m_endpointManager->endpoint(job.endpoint).address() << "确认文件" << fileName << "接收成功（io_uring）。\033[0m";
+            m_retryScheduler->clear(job.filePath);
+            m_fileStatus[job.filePath] = Success;
+            m_endpointManager->reportSuccess(job.endpoint, bytes, elapsedMs);
+            m_endpointManager->release(job.endpoint);
+            updateStatistics();
+            disposeFile(job.filePath);
+        } else if (errorClass == RetryScheduler::ServerFailure) {
+            qDebug() << "\033[31m服务器返回失败，文件" << fileName << "未成功接收。\033[0m";
+            // 服务器能够响应，说明接收端在线，不计入熔断
+            m_endpointManager->reportError(job.endpoint, false);
+            m_endpointManager->release(job.endpoint);
+            retryLater(job.filePath, RetryScheduler::ServerFailure);
+        } else {
+            qDebug() << "\033[31mio_uring 发送失败：" << error << "，文件" << fileName << "\033[0m";
+            m_endpointManager->reportError(job.endpoint);
+            m_endpointManager->release(job.endpoint);
+            retryLater(job.filePath, static_cast<RetryScheduler::ErrorClass>(errorClass));
+        }
+    }
+
+    updateTransferProgress();
+    startFileTransfer();
+}
+
+// 返回 io_uring 引擎使用的数字地址：IP 地址直接使用，主机名在主线程异步解析并缓存 HOST_CACHE_MS，
+// 过期后仍先使用旧地址，同时在后台重新解析；尚无结果时返回空字符串
+QString MainWindow::ioUringAddress(const QString &host)
+{
+    if (!QHostAddress(host).isNull()) {
+        return host;
+    }
+
+    auto cached = m_resolvedHosts.constFind(host);
+    QString address = cached != m_resolvedHosts.constEnd() ? cached->address : QString();
+    bool fresh = !address.isEmpty() && cached->expiresAt > QDateTime::currentMSecsSinceEpoch();
+    if (!fresh && !m_resolvingHosts.contains(host)) {
+        m_resolvingHosts.insert(host);
+        QHostInfo::lookupHost(host, this, [this, host](const QHostInfo &info) {
+            m_resolvingHosts.remove(host);
+            if (info.error() == QHostInfo::NoError && !info.addresses().isEmpty()) {
+                m_resolvedHosts.insert(host, {info.addresses().first().toString(),
+                                              QDateTime::currentMSecsSinceEpoch() + HOST_CACHE_MS});
+            } else {
+                // 解析失败按连接失败处理，熔断后由其他接收端接管
+                qDebug() << "\033[31m解析主机名" << host << "失败：" << info.errorString() << "\033[0m";
+                for (int i = 0; i < m_endpointManager->count(); ++i) {
+                    if (m_endpointManager->endpoint(i).host == host) {
+                        m_endpointManager->reportConnectFailure(i, info.errorString());
+                    }
+                }
+            }
+            startFileTransfer();
+        });
+    }
+
+    return address;
+}
+
+// io_uring 引擎无法继续工作：尚未回报结果的文件放回队首，改用 Qt 发送路径
+void MainWindow::onIoUringEngineFailed(const QString &error)
+{
+    qDebug() << "\033[31mio_uring 引擎出错，改用 Qt 发送路径：" << error << "\033[0m";
+
+    // 按提交顺序倒序放回队首，保持原有发送顺序
+    QList<quint64> ids = m_ioUringJobs.keys();
+    std::sort(ids.begin(), ids.end(), std::greater<quint64>());
+    for (quint64 id : ids) {
+        const IoUringJob &job = m_ioUringJobs[id];
+        m_endpointManager->release(job.endpoint);
+        m_pendingFiles.prepend(job.filePath);
+    }
+    m_ioUringJobs.clear();
+    m_transferTuner->setActiveTransfers(m_transfers.size());
+
+    ui->ioUringCheckBox->setChecked(false);
+    ui->ioUringCheckBox->setEnabled(false);
+    ui->ioUringCheckBox->setToolTip("io_uring 引擎出错：" + error);
+
+    updateTransferProgress();
+    applyStreamLimit();
+    startFileTransfer();
+}
+
+void MainWindow::onIoUringStatistics(quint64 files, quint64 syscalls, double filesPerSecond)
+{
+    m_ioUringFiles = files;
+    m_ioUringSyscalls = syscalls;
+    m_ioUringFilesPerSecond = filesPerSecond;
+    updateIoEngineStatistics();
+}
+
+// 对比两种发送路径的 files/sec；io_uring 引擎自行统计系统调用次数，Qt 路径可用 strace -c 对照
+void MainWindow::updateIoEngineStatistics()
+{
+    if (!ui->label_ioEngine) {
+        return;
+    }
+
+    qint64 qtBusyMs = m_qtBusyMs + (m_qtBusyTimer.isValid() ? m_qtBusyTimer.elapsed() : 0);
+    QString text = QString("发送引擎：%1；Qt 路径 %2 个文件，%3 files/s")
+                       .arg(ioUringEnabled() ? "io_uring 批量发送" : "Qt")
+                       .arg(m_qtFilesDone)
+                       .arg(qtBusyMs > 0 ? m_qtFilesDone * 1000.0 / qtBusyMs : 0.0, 0, 'f', 1);
+    if (m_ioUringWorker) {
+        text += QString("；io_uring %1 个文件，%2 files/s，系统调用 %3 次（%4 次/文件）")
+                    .arg(m_ioUringFiles)
+                    .arg(m_ioUringFilesPerSecond, 0, 'f', 1)
+                    .arg(m_ioUringSyscalls)
+                    .arg(m_ioUringFiles > 0 ? double(m_ioUringSyscalls) / m_ioUringFiles : 0.0, 0, 'f', 1);
+    }
+    ui->label_ioEngine->setText(text);
+}
+
+// 按文件所在监控目录的策略请求归档、链接、删除或隔离
+void MainWindow::disposeFile(const QString &filePath)
+{
+    FileStatus status = m_fileStatus.value(filePath, Pending);
+    if (status == Pending) {
+        return;
+    }
+
+    QString rootPath = QDir::cleanPath(QFileInfo(filePath).path());
+    if (!m_dispositionPolicies.contains(rootPath)) {
+        return;
+    }
+    emit dispositionRequested(filePath, status == Success, m_dispositionPolicies.value(rootPath));
+}
+
+// 传输后处理完成的回调
+void MainWindow::onFileDisposed(const QString &filePath, const QString &action, const QString &target, bool ok, const QString &error)
+{
+    if (!ok) {
+        qDebug() << "\033[31m文件" << QFileInfo(filePath).fileName() << action << "失败：" << error << "\033[0m";
+        return;
+    }
+    qDebug() << "文件" << QFileInfo(filePath).fileName() << action << (target.isEmpty() ? QString() : "到 " + target);
+
+    // 文件已离开监控目录：只保留计数，移除状态记录，之后出现的同名文件按新文件发送
+    FileStatus status = m_fileStatus.take(filePath);
+    if (status == Success) {
+        m_disposedSuccess++;
+    } else if (status == Failure) {
+        m_disposedFailure++;
+    }
+
+    // 处理期间生产者可能已写入同名新文件，此时的目录变化已被忽略，需要重新加入队列
+    if (QFileInfo::exists(filePath)) {
+        m_fileStatus[filePath] = Pending;
+        m_pendingFiles.enqueue(filePath);
+        startFileTransfer();
+    }
+    updateStatistics();
 }
 
 // 接收日志消息的槽函数
@@ -368,9 +891,9 @@ void MainWindow::onLogMessage(const QString &message)
 // 更新统计标签的槽函数
 void MainWindow::updateStatistics()
 {
-    int totalFiles = m_fileStatus.size();
-    int successFiles = 0;
-    int failedFiles = 0;
+    int totalFiles = m_fileStatus.size() + m_disposedSuccess + m_disposedFailure;
+    int successFiles = m_disposedSuccess;
+    int failedFiles = m_disposedFailure;
 
     for (FileStatus status : m_fileStatus.values()) {
         if (status == Success) {
@@ -8,10 +8,18 @@
 #include <QSet>
 #include <QFile>
 #include <QMap>
+#include <QHash>
 #include <QTimer>
 #include <QElapsedTimer>
 #include <QQueue>
 #include "logmanager.h"
+#include "endpointmanager.h"
+#include "dispositionworker.h"
+#include "retryscheduler.h"
+#include "transfertuner.h"
+
+class QThread;
+class IoUringWorker;
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
@@ -25,6 +33,9 @@ public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
 
+signals:
+    void dispositionRequested(const QString &filePath, bool success, const DispositionPolicy &policy);
+
 private slots:
     void on_pushButton_clicked();
     void on_stopButton_clicked();
@@ -40,6 +51,12 @@ private slots:
     void onSocketReadyRead();
     void onSocketError(QAbstractSocket::SocketError socketError);
     // void onBytesWritten(qint64 bytes);
+    void updateEndpointStatistics();
+    void onRetryReady(const QString &filePath);
+    void onTuningChanged(const TransferTuning &tuning);
+    void applyManualTuning();
+    void updateTuningStatistics();
+    void onFileDisposed(const QString &filePath, const QString &action, const QString &target, bool ok, const QString &error);
 
 private:
     // 文件状态枚举
@@ -49,22 +66,87 @@ private:
         Failure   // 发送失败
     };
 
+    // 单个文件传输的上下文，允许多个文件并行发送到不同接收端
+    struct FileTransfer {
+        QString filePath;
+        int endpoint = -1;
+        QTcpSocket *socket = nullptr;
+        QFile *file = nullptr;
+        qint64 fileSize = 0;
+        qint64 bytesWritten = 0;    // 已交给内核的文件数据量
+        QElapsedTimer timer;
+        bool connected = false;
+        bool awaitingResponse = false;
+    };
+
+    // 提交给 io_uring 引擎的文件，以提交编号为键
+    struct IoUringJob {
+        QString filePath;
+        int endpoint = -1;
+    };
+
+    // io_uring 引擎使用的主机名解析结果
+    struct ResolvedHost {
+        QString address;
+        qint64 expiresAt = 0;
+    };
+
+    bool beginTransfer(const QString &filePath, int endpoint);
+    bool fillSocket(QTcpSocket *socket);
+    void finishTransfer(QTcpSocket *socket);
+    void retryLater(const QString &filePath, RetryScheduler::ErrorClass errorClass);
+    void updateTransferProgress();
+    void disposeFile(const QString &filePath);
+    bool ioUringEnabled() const;
+    void applyStreamLimit();
+    QString ioUringAddress(const QString &host);
+    void onIoUringEngineFailed(const QString &error);
+    void onIoUringFileFinished(quint64 id, bool success, bool connectFailed, bool fileFailed, int errorClass,
+                               const QString &error, qint64 bytes, qint64 connectMs, qint64 elapsedMs);
+    void onIoUringStatistics(quint64 files, quint64 syscalls, double filesPerSecond);
+    void updateIoEngineStatistics();
+
     Ui::MainWindow *ui;
     QFileSystemWatcher *myFileSystemWatcher;
 
     // 用于跟踪所有文件的状态
     QMap<QString, FileStatus> m_fileStatus;
-    // 用于跟踪每个文件重试次数的映射
-    QMap<QString, int> m_fileRetries;
+    // 已归档、链接、删除或隔离的文件不再保留状态记录，只计入统计
+    int m_disposedSuccess = 0;
+    int m_disposedFailure = 0;
+    // 集中管理所有文件的重试次数与退避时间
+    RetryScheduler *m_retryScheduler;
+
+    // 块大小、发送缓冲、高水位与并发数的自动调优
+    TransferTuner *m_transferTuner;
 
     // 新增: 用于文件传输队列和状态管理
     QQueue<QString> m_pendingFiles;
-    bool m_isSendingFile = false;
+    // 正在进行的传输，以各自的 socket 为键
+    QHash<QTcpSocket*, FileTransfer*> m_transfers;
+
+    // 接收端列表、负载均衡与故障转移
+    EndpointManager *m_endpointManager;
+
+    // 每个监控目录的传输后处理策略，以及执行处理的线程
+    QMap<QString, DispositionPolicy> m_dispositionPolicies;
+    QThread *m_dispositionThread;
+
+    // 可选的 io_uring 批量发送引擎（仅 Linux，编译时启用且内核支持时才创建）
+    IoUringWorker *m_ioUringWorker = nullptr;
+    QThread *m_ioUringThread = nullptr;
+    QHash<quint64, IoUringJob> m_ioUringJobs;
+    quint64 m_nextIoUringJobId = 0;
+    QHash<QString, ResolvedHost> m_resolvedHosts;
+    QSet<QString> m_resolvingHosts;
 
-    // 用于文件传输进度的成员变量
-    QElapsedTimer m_speedTimer;
-    qint64 m_bytesWrittenTotal = 0;
-    qint64 m_fileSize = 0;
+    // 两种发送路径的对比统计：files/sec 只按有文件在发送的时间计算
+    QElapsedTimer m_qtBusyTimer;
+    qint64 m_qtBusyMs = 0;
+    quint64 m_qtFilesDone = 0;
+    quint64 m_ioUringFiles = 0;
+    quint64 m_ioUringSyscalls = 0;
+    double m_ioUringFilesPerSecond = 0.0;
 
     QTcpSocket *m_messageSocket;
 };
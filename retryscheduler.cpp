@@ -0,0 +1,121 @@
+#include "retryscheduler.h"
+#include <QDebug>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QRandomGenerator>
+
+RetryScheduler::RetryScheduler(QObject *parent)
+    : QObject(parent)
+    , m_timer(new QTimer(this))
+{
+    connect(m_timer, &QTimer::timeout, this, &RetryScheduler::onTimeout);
+    m_timer->setSingleShot(true);
+
+    // 默认重试策略：{最大重试次数, 基础延迟, 最大延迟}
+    m_policies.insert(Timeout, {5, 2000, 60000});
+    m_policies.insert(ConnectionReset, {5, 1000, 30000});
+    // 拒绝连接由接收端熔断处理，不消耗文件的重试次数，这里仅作兜底
+    m_policies.insert(ConnectionRefused, {10, 2000, 60000});
+    m_policies.insert(ServerFailure, {2, 5000, 30000});
+    m_policies.insert(Other, {3, 2000, 30000});
+}
+
+RetryScheduler::ErrorClass RetryScheduler::classify(QAbstractSocket::SocketError socketError)
+{
+    switch (socketError) {
+    case QAbstractSocket::SocketTimeoutError:
+        return Timeout;
+    case QAbstractSocket::RemoteHostClosedError:
+    case QAbstractSocket::NetworkError:
+        return ConnectionReset;
+    case QAbstractSocket::ConnectionRefusedError:
+    case QAbstractSocket::HostNotFoundError:
+        return ConnectionRefused;
+    default:
+        return Other;
+    }
+}
+
+QString RetryScheduler::errorClassName(ErrorClass errorClass)
+{
+    switch (errorClass) {
+    case Timeout:
+        return "超时";
+    case ConnectionReset:
+        return "连接断开";
+    case ConnectionRefused:
+        return "拒绝连接";
+    case ServerFailure:
+        return "服务器返回失败";
+    case Other:
+        return "其他错误";
+    }
+    return QString();
+}
+
+int RetryScheduler::backoffDelay(int attempt, int baseDelayMs, int maxDelayMs)
+{
+    qint64 delay = baseDelayMs;
+    for (int i = 1; i < attempt && delay < maxDelayMs; ++i) {
+        delay *= 2;
+    }
+    delay = qMin<qint64>(delay, maxDelayMs);
+
+    // 随机抖动，避免大量文件在同一时刻集中重试
+    int half = static_cast<int>(delay / 2);
+    return half + QRandomGenerator::global()->bounded(half + 1);
+}
+
+bool RetryScheduler::schedule(const QString &filePath, ErrorClass errorClass)
+{
+    const Policy policy = m_policies.value(errorClass);
+    QHash<int, int> &attempts = m_attempts[filePath];
+    int attempt = attempts.value(errorClass, 0) + 1;
+
+    if (attempt > policy.maxRetries) {
+        qDebug() << "\033[31m文件" << QFileInfo(filePath).fileName() << "因" << errorClassName(errorClass) << "已达到最大重试次数，放弃传输。\033[0m";
+        m_attempts.remove(filePath);
+        return false;
+    }
+
+    attempts.insert(errorClass, attempt);
+    int delay = backoffDelay(attempt, policy.baseDelayMs, policy.maxDelayMs);
+    m_due.insert(QDateTime::currentMSecsSinceEpoch() + delay, filePath);
+    qDebug() << "文件" << QFileInfo(filePath).fileName() << "因" << errorClassName(errorClass)
+             << "将在" << delay << "毫秒后第" << attempt << "次重试。";
+
+    armTimer();
+    return true;
+}
+
+void RetryScheduler::clear(const QString &filePath)
+{
+    m_attempts.remove(filePath);
+}
+
+// 取出所有已到期的文件，然后按下一个到期时间重新启动定时器
+void RetryScheduler::onTimeout()
+{
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    QStringList ready;
+    while (!m_due.isEmpty() && m_due.firstKey() <= now) {
+        ready << m_due.first();
+        m_due.erase(m_due.begin());
+    }
+
+    armTimer();
+
+    for (const QString &filePath : ready) {
+        emit retryReady(filePath);
+    }
+}
+
+void RetryScheduler::armTimer()
+{
+    if (m_due.isEmpty()) {
+        m_timer->stop();
+        return;
+    }
+    qint64 wait = m_due.firstKey() - QDateTime::currentMSecsSinceEpoch();
+    m_timer->start(static_cast<int>(qMax<qint64>(0, wait)));
+}
@@ -0,0 +1,60 @@
+#ifndef RETRYSCHEDULER_H
+#define RETRYSCHEDULER_H
+
+#include <QObject>
+#include <QAbstractSocket>
+#include <QHash>
+#include <QMultiMap>
+#include <QTimer>
+
+// 集中管理所有文件的重试：按错误类型选择策略，指数退避并加入随机抖动
+class RetryScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    // 失败原因分类，不同类型使用不同的重试策略
+    enum ErrorClass {
+        Timeout,            // 等待服务器响应超时
+        ConnectionReset,    // 传输过程中连接被断开
+        ConnectionRefused,  // 接收端拒绝连接
+        ServerFailure,      // 服务器返回 FAILURE
+        Other               // 文件无法打开、未知响应等
+    };
+
+    struct Policy {
+        int maxRetries = 5;
+        int baseDelayMs = 2000;
+        int maxDelayMs = 60000;
+    };
+
+    explicit RetryScheduler(QObject *parent = nullptr);
+
+    static ErrorClass classify(QAbstractSocket::SocketError socketError);
+    static QString errorClassName(ErrorClass errorClass);
+    // 第 attempt 次重试的等待时间：base * 2^(attempt-1)，不超过 max，并在 [delay/2, delay] 范围内随机抖动
+    static int backoffDelay(int attempt, int baseDelayMs, int maxDelayMs);
+
+    // 安排一次重试，超出该错误类型的重试次数时返回 false
+    bool schedule(const QString &filePath, ErrorClass errorClass);
+    // 文件发送成功或最终失败后清除重试记录
+    void clear(const QString &filePath);
+
+signals:
+    void retryReady(const QString &filePath);
+
+private slots:
+    void onTimeout();
+
+private:
+    void armTimer();
+
+    QHash<int, Policy> m_policies;
+    // 每个文件按错误类型分别记录已重试次数，各类型的重试次数与退避互不影响
+    QHash<QString, QHash<int, int>> m_attempts;
+    // 以到期时间（毫秒时间戳）排序的待重试文件，由同一个定时器驱动
+    QMultiMap<qint64, QString> m_due;
+    QTimer *m_timer;
+};
+
+#endif // RETRYSCHEDULER_H
@@ -0,0 +1,150 @@
+#include "transfertuner.h"
+#include <QDebug>
+
+// 调优周期与各参数的取值范围
+const int TUNE_INTERVAL_MS = 2000;
+const int MIN_CHUNK_SIZE = 16 * 1024;
+const int MAX_CHUNK_SIZE = 1024 * 1024;
+const int MIN_SEND_BUFFER = 64 * 1024;
+const int MAX_SEND_BUFFER = 8 * 1024 * 1024;
+const int MIN_HIGH_WATER_MARK = 64 * 1024;
+const int MAX_HIGH_WATER_MARK = 8 * 1024 * 1024;
+const int MAX_STREAMS_PER_ENDPOINT = 8;
+// 吞吐量变化超过该比例才调整并发数
+const double STREAM_STEP_THRESHOLD = 0.05;
+// 平滑系数
+const double SMOOTHING_ALPHA = 0.3;
+
+TransferTuner::TransferTuner(QObject *parent)
+    : QObject(parent)
+    , m_tickTimer(new QTimer(this))
+{
+    connect(m_tickTimer, &QTimer::timeout, this, &TransferTuner::onTick);
+    m_tickTimer->start(TUNE_INTERVAL_MS);
+    m_intervalTimer.start();
+}
+
+void TransferTuner::setMode(Mode mode)
+{
+    if (m_mode == mode) {
+        return;
+    }
+    m_mode = mode;
+    m_lastThroughput = 0.0;
+    m_streamDirection = 1;
+
+    if (m_mode == Manual) {
+        applyTuning(m_manualTuning, "手动设置");
+    } else {
+        qDebug() << "传输参数切换为自动调优。";
+    }
+}
+
+void TransferTuner::setManualTuning(const TransferTuning &tuning)
+{
+    m_manualTuning = tuning;
+    if (m_mode == Manual) {
+        applyTuning(m_manualTuning, "手动设置");
+    }
+}
+
+void TransferTuner::addRttSample(qint64 rttMs)
+{
+    double sample = qMax<qint64>(1, rttMs);
+    m_rttMs = m_rttMs <= 0.0 ? sample : SMOOTHING_ALPHA * sample + (1.0 - SMOOTHING_ALPHA) * m_rttMs;
+}
+
+QString TransferTuner::statisticsText() const
+{
+    return QString("%1：块大小 %2 KB，发送缓冲 %3，高/低水位 %4/%5 KB，并发 %6/接收端，吞吐量 %7 MB/s，RTT %8 ms")
+        .arg(m_mode == Auto ? "自动调优" : "手动设置")
+        .arg(m_tuning.chunkSize / 1024)
+        .arg(m_tuning.sendBufferSize > 0 ? QString("%1 KB").arg(m_tuning.sendBufferSize / 1024) : QString("系统默认"))
+        .arg(m_tuning.highWaterMark / 1024)
+        .arg(m_tuning.lowWaterMark / 1024)
+        .arg(m_tuning.streamsPerEndpoint)
+        .arg(m_throughput / (1024.0 * 1024.0), 0, 'f', 2)
+        .arg(m_rttMs, 0, 'f', 1);
+}
+
+// 每个周期根据带宽时延积调整缓冲与块大小，并以爬山法调整并发数
+void TransferTuner::onTick()
+{
+    qint64 elapsedMs = m_intervalTimer.restart();
+    qint64 bytes = m_intervalBytes;
+    m_intervalBytes = 0;
+    int streams = qMax(1, m_intervalMaxTransfers);
+    m_intervalMaxTransfers = m_activeTransfers;
+
+    // 空闲周期没有有效的测量数据
+    if (elapsedMs <= 0 || bytes == 0) {
+        return;
+    }
+
+    double throughput = bytes * 1000.0 / elapsedMs;
+    m_throughput = m_throughput <= 0.0 ? throughput : SMOOTHING_ALPHA * throughput + (1.0 - SMOOTHING_ALPHA) * m_throughput;
+    emit statisticsChanged();
+
+    if (m_mode == Manual) {
+        return;
+    }
+
+    TransferTuning next = m_tuning;
+
+    // 带宽时延积：保证在途数据至少能填满链路，缓冲留出一倍余量
+    // 所有连接分摊总吞吐量，按周期内最大并发数平分，避免每个 socket 都按整条链路分配缓冲
+    double bdp = m_throughput / streams * qMax(1.0, m_rttMs) / 1000.0;
+    next.sendBufferSize = roundToPowerOfTwo(2 * bdp, MIN_SEND_BUFFER, MAX_SEND_BUFFER);
+    next.highWaterMark = roundToPowerOfTwo(2 * bdp, MIN_HIGH_WATER_MARK, MAX_HIGH_WATER_MARK);
+    next.lowWaterMark = next.highWaterMark / 4;
+    next.chunkSize = roundToPowerOfTwo(next.highWaterMark / 4.0, MIN_CHUNK_SIZE, MAX_CHUNK_SIZE);
+
+    if (m_backlogged) {
+        if (m_lastThroughput > 0.0) {
+            if (throughput < m_lastThroughput * (1.0 - STREAM_STEP_THRESHOLD)) {
+                // 吞吐量下降，说明上一步方向错误，反向调整
+                m_streamDirection = -m_streamDirection;
+                next.streamsPerEndpoint += m_streamDirection;
+            } else if (throughput > m_lastThroughput * (1.0 + STREAM_STEP_THRESHOLD)) {
+                next.streamsPerEndpoint += m_streamDirection;
+            }
+        } else {
+            next.streamsPerEndpoint += m_streamDirection;
+        }
+        next.streamsPerEndpoint = qBound(1, next.streamsPerEndpoint, MAX_STREAMS_PER_ENDPOINT);
+        // 到达边界后改为向另一方向探索
+        if (next.streamsPerEndpoint == 1) {
+            m_streamDirection = 1;
+        } else if (next.streamsPerEndpoint == MAX_STREAMS_PER_ENDPOINT) {
+            m_streamDirection = -1;
+        }
+        m_lastThroughput = throughput;
+    }
+
+    applyTuning(next, QString("吞吐量 %1 MB/s，RTT %2 ms")
+                          .arg(throughput / (1024.0 * 1024.0), 0, 'f', 2)
+                          .arg(m_rttMs, 0, 'f', 1));
+}
+
+void TransferTuner::applyTuning(const TransferTuning &tuning, const QString &reason)
+{
+    if (tuning == m_tuning) {
+        return;
+    }
+    m_tuning = tuning;
+    qDebug() << "传输参数调整（" << reason << "）：块大小" << m_tuning.chunkSize / 1024 << "KB，发送缓冲"
+             << m_tuning.sendBufferSize / 1024 << "KB，高/低水位" << m_tuning.highWaterMark / 1024
+             << "/" << m_tuning.lowWaterMark / 1024
+             << "KB，每个接收端并发" << m_tuning.streamsPerEndpoint;
+    emit tuningChanged(m_tuning);
+    emit statisticsChanged();
+}
+
+int TransferTuner::roundToPowerOfTwo(double value, int minValue, int maxValue)
+{
+    int result = minValue;
+    while (result < value && result < maxValue) {
+        result *= 2;
+    }
+    return qMin(result, maxValue);
+}
@@ -0,0 +1,89 @@
+#ifndef TRANSFERTUNER_H
+#define TRANSFERTUNER_H
+
+#include <QObject>
+#include <QMetaType>
+#include <QElapsedTimer>
+#include <QTimer>
+
+// 发送路径的可调参数
+struct TransferTuning
+{
+    int chunkSize = 64 * 1024;       // 每次从文件读取并写入 socket 的块大小
+    int sendBufferSize = 0;          // SO_SNDBUF，0 表示使用系统默认值
+    int highWaterMark = 256 * 1024;  // socket 写缓冲的高水位，补充数据时填充到该值
+    int lowWaterMark = 64 * 1024;    // socket 写缓冲低于该值时开始补充数据
+    int streamsPerEndpoint = 1;      // 每个接收端的并发传输数
+
+    bool operator==(const TransferTuning &other) const
+    {
+        return chunkSize == other.chunkSize && sendBufferSize == other.sendBufferSize
+            && highWaterMark == other.highWaterMark && lowWaterMark == other.lowWaterMark
+            && streamsPerEndpoint == other.streamsPerEndpoint;
+    }
+    bool operator!=(const TransferTuning &other) const { return !(*this == other); }
+};
+
+Q_DECLARE_METATYPE(TransferTuning)
+
+// 根据测得的吞吐量和 RTT 调整块大小、发送缓冲、高水位与并发数，也可切换为手动设置
+class TransferTuner : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Mode {
+        Auto,
+        Manual
+    };
+
+    explicit TransferTuner(QObject *parent = nullptr);
+
+    Mode mode() const { return m_mode; }
+    void setMode(Mode mode);
+    void setManualTuning(const TransferTuning &tuning);
+    TransferTuning tuning() const { return m_tuning; }
+
+    // 由发送路径上报的测量数据
+    void addBytes(qint64 bytes) { m_intervalBytes += bytes; }
+    void addRttSample(qint64 rttMs);
+    // 队列中仍有待发送文件时并发数的变化才有意义
+    void setBacklogged(bool backlogged) { m_backlogged = backlogged; }
+    // 当前并发传输数：吞吐量是所有连接的总和，缓冲按单个连接的份额计算
+    void setActiveTransfers(int count)
+    {
+        m_activeTransfers = count;
+        m_intervalMaxTransfers = qMax(m_intervalMaxTransfers, count);
+    }
+
+    QString statisticsText() const;
+
+signals:
+    void tuningChanged(const TransferTuning &tuning);
+    void statisticsChanged();
+
+private slots:
+    void onTick();
+
+private:
+    void applyTuning(const TransferTuning &tuning, const QString &reason);
+    static int roundToPowerOfTwo(double value, int minValue, int maxValue);
+
+    Mode m_mode = Auto;
+    TransferTuning m_tuning;
+    TransferTuning m_manualTuning;
+
+    QTimer *m_tickTimer;
+    QElapsedTimer m_intervalTimer;
+    qint64 m_intervalBytes = 0;
+    bool m_backlogged = false;
+    int m_activeTransfers = 0;
+    int m_intervalMaxTransfers = 0; // 本周期内的最大并发传输数
+
+    double m_throughput = 0.0;     // 平滑后的吞吐量 (字节/秒)
+    double m_rttMs = 0.0;          // 平滑后的 RTT (毫秒)
+    double m_lastThroughput = 0.0; // 上一个周期的吞吐量，用于并发数爬山调节
+    int m_streamDirection = 1;
+};
+
+#endif // TRANSFERTUNER_H